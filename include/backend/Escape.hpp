@@ -0,0 +1,19 @@
+#ifndef ESCAPE_HPP
+#define ESCAPE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace toyjson::backend {
+    /// @brief Finds the first byte at or after pos that JSON requires escaping ('\"', '\\' or a control character), 16 or 32 bytes at a time. Returns npos if there is none.
+    [[nodiscard]] size_t findEscapeChar(std::string_view text, size_t pos);
+
+    /**
+     * @brief Appends text as a string body, escaping only what JSON requires. Runs with nothing to escape are copied with a single append.
+     * @note Bytes at or above 0x80 pass through untouched, so valid UTF-8 stays UTF-8.
+     */
+    void appendEscaped(std::string_view text, std::string& out);
+}
+
+#endif
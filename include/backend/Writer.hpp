@@ -0,0 +1,100 @@
+#ifndef WRITER_HPP
+#define WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "data/Value.hpp"
+
+namespace toyjson::backend {
+    enum class WriteStyle {
+        compact, // no whitespace at all
+        pretty   // one member or item per line, indented
+    };
+
+    struct WriteOptions {
+        WriteStyle style = WriteStyle::compact;
+        size_t indent_width = 4;
+    };
+
+    /**
+     * @brief Streaming JSON builder. Values are appended straight to an output buffer as they are written, with commas, colons and indentation placed automatically, so nothing like a DOM is built first.
+     * @note Numbers use std::to_chars: doubles print in their shortest form that reads back to the same bits. Doubles with integral values keep a ".0" so they reparse as doubles, and NaN or infinity, which JSON cannot express, print as null.
+     */
+    class JsonWriter {
+        public:
+            /// @brief Output past this many bytes is written through to the descriptor, if there is one.
+            static constexpr size_t flush_threshold = 64 * 1024;
+
+            /// @brief Writes into an internal buffer. See getText() and releaseText().
+            explicit JsonWriter(WriteOptions x_options = {});
+
+            /// @brief Writes to a descriptor, buffering up to flush_threshold bytes between writes. The descriptor is not closed.
+            /// @note Call flush() after the last value, as destruction does not.
+            JsonWriter(int x_fd, WriteOptions x_options = {});
+
+            JsonWriter(const JsonWriter& other) = delete;
+            JsonWriter& operator=(const JsonWriter& other) = delete;
+
+            /// @throws std::runtime_error on misplaced calls, such as a key outside an object or an unmatched end.
+            JsonWriter& beginObject();
+            JsonWriter& endObject();
+            JsonWriter& beginArray();
+            JsonWriter& endArray();
+            JsonWriter& writeKey(std::string_view key);
+
+            JsonWriter& writeNull();
+            JsonWriter& writeBoolean(bool flag);
+            JsonWriter& writeNumber(double num);
+            JsonWriter& writeNumber(int num);
+            JsonWriter& writeNumber(std::int64_t num);
+            JsonWriter& writeNumber(std::uint64_t num);
+            JsonWriter& writeString(std::string_view text);
+
+            /// @brief Writes a whole tree value, members in their stored order.
+            JsonWriter& writeValue(const data::IJsonValue& value);
+
+            /// @throws std::system_error if the descriptor rejects the write.
+            void flush();
+
+            /// @brief True once exactly one top-level value is finished.
+            [[nodiscard]] bool isComplete() const;
+
+            /// @note Holds only what has not been flushed yet in descriptor mode.
+            [[nodiscard]] std::string_view getText() const;
+            [[nodiscard]] std::string releaseText();
+
+        private:
+            struct Level {
+                bool is_object;
+                bool has_items;
+            };
+
+            std::string buffer;
+            std::vector<Level> levels;
+            WriteOptions options;
+            int fd;
+            bool after_key;
+            bool complete;
+
+            void beforeValue();
+            void afterValue();
+            void beginContainer(bool is_object, char opener);
+            void endContainer(bool is_object, char closer);
+            void breakLine(size_t depth);
+            void appendQuoted(std::string_view text);
+    };
+
+    /**
+     * @brief Serializes a tree document to text.
+     * @throws std::runtime_error for tape documents, which have no tree to walk.
+     */
+    [[nodiscard]] std::string serialize(const data::ToyJsonDocument& doc, WriteOptions options = {});
+
+    /// @brief Serializes a tree document straight to a descriptor, flushing at the end.
+    void serializeTo(int fd, const data::ToyJsonDocument& doc, WriteOptions options = {});
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef CORPUS_HPP
+#define CORPUS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace toyjson::bench {
+    enum class CorpusKind {
+        twitter,    // string-heavy statuses with nested users and entities
+        canada,     // number-heavy polygon coordinates
+        nested,     // deep alternating objects and arrays
+        wide,       // objects with hundreds of members each
+        small_docs, // many separate event records of a few hundred bytes
+        ndjson      // the same records as one newline-delimited text
+    };
+
+    inline constexpr CorpusKind all_corpus_kinds[] {
+        CorpusKind::twitter, CorpusKind::canada, CorpusKind::nested, CorpusKind::wide, CorpusKind::small_docs, CorpusKind::ndjson
+    };
+
+    [[nodiscard]] constexpr std::string_view toCorpusName(CorpusKind kind) {
+        using std::operator""sv;
+
+        if (kind == CorpusKind::twitter)
+            return "twitter"sv;
+        else if (kind == CorpusKind::canada)
+            return "canada"sv;
+        else if (kind == CorpusKind::nested)
+            return "nested"sv;
+        else if (kind == CorpusKind::wide)
+            return "wide"sv;
+        else if (kind == CorpusKind::small_docs)
+            return "small_docs"sv;
+
+        return "ndjson"sv;
+    }
+
+    [[nodiscard]] std::optional<CorpusKind> findCorpusKind(std::string_view name);
+
+    struct Corpus {
+        CorpusKind kind;
+        std::vector<std::string> docs; // one entry per document, so single-document corpora hold one
+        std::string lines;             // every doc joined by newlines, only filled for ndjson
+        size_t bytes;                  // total of docs
+    };
+
+    /**
+     * @brief Builds a synthetic corpus of roughly target_bytes. The output depends only on the arguments, so runs on different builds or machines parse identical text.
+     */
+    [[nodiscard]] Corpus generateCorpus(CorpusKind kind, size_t target_bytes, std::uint64_t seed = 0x70794A534F4EULL);
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef MEASURE_HPP
+#define MEASURE_HPP
+
+#include <cstddef>
+
+namespace toyjson::bench {
+    /// @brief Running totals of global operator new and delete calls in this process.
+    struct AllocCounts {
+        size_t allocs;
+        size_t frees;
+        size_t bytes;
+    };
+
+    [[nodiscard]] AllocCounts readAllocCounts();
+
+    [[nodiscard]] constexpr AllocCounts operator-(const AllocCounts& lhs, const AllocCounts& rhs) {
+        return AllocCounts {.allocs = lhs.allocs - rhs.allocs, .frees = lhs.frees - rhs.frees, .bytes = lhs.bytes - rhs.bytes};
+    }
+
+    /**
+     * @brief Restarts the peak resident set size from the current one, so each corpus reports its own peak.
+     * @return false where the kernel offers no reset, in which case the peak stays process-wide.
+     */
+    bool resetPeakRss();
+
+    /// @brief Peak resident set size in KiB since the last reset or process start.
+    [[nodiscard]] size_t readPeakRssKb();
+}
+
+#endif
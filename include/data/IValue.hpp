@@ -2,10 +2,11 @@
 #define IVALUE_HPP
 
 #include <any>
+#include <cstdint>
 
 namespace toyjson::data {
 
-    enum class JsonType {
+    enum class JsonType : std::uint8_t {
         j_null,
         j_boolean,
         j_number,
@@ -15,12 +16,36 @@ namespace toyjson::data {
         j_any
     };
 
+    /// @brief Exact storage kind of a JSON number. Integral literals keep every bit instead of rounding through double.
+    enum class NumberKind : std::uint8_t {
+        j_double,
+        j_int64,
+        j_uint64
+    };
+
     class IJsonValue {
     public:
         virtual ~IJsonValue() = default;
 
         [[nodiscard]] virtual JsonType getType() const = 0;
+
+        /// @note Scalars box a copy of their value and containers a const pointer to themselves, but AnyField boxes a full copy of itself. Prefer getIf(), as() or visit(), which never copy.
         [[nodiscard]] virtual std::any toBoxedValue() const = 0;
+
+        /**
+         * @brief Views this value as a concrete field type, looking through AnyField wrappers. No copy.
+         * @return nullptr if the value holds another type.
+         */
+        template <typename Field>
+        [[nodiscard]] const Field* getIf() const;
+
+        /// @throws std::runtime_error if the value holds another type.
+        template <typename Field>
+        [[nodiscard]] const Field& as() const;
+
+        /// @brief Calls fn with the concrete field this value holds, looking through AnyField wrappers, and returns its result. Every overload of fn must return the same type.
+        template <typename Fn>
+        decltype(auto) visit(Fn&& fn) const;
     };
 }
 
@@ -0,0 +1,58 @@
+#ifndef KEY_TABLE_HPP
+#define KEY_TABLE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace toyjson::data {
+    /// @brief One stored key. Its address is the key's identity within the table that made it.
+    struct KeyEntry {
+        std::string_view text;
+        size_t hash;
+    };
+
+    /// @brief Interned key handle. Two keys from the same table are equal exactly when the pointers are.
+    using Key = const KeyEntry*;
+
+    /**
+     * @brief Stores each distinct object key once. Objects then hold a Key per member instead of a string copy, and compare keys by address.
+     * @note Entries never move or die before the table, so Keys stay valid for its lifetime. Thread-safe, so one table can be shared by concurrent parses.
+     */
+    class KeyTable {
+        public:
+            KeyTable();
+
+            /// @param resource Backs the key text and index. Must outlive the table.
+            explicit KeyTable(std::pmr::memory_resource* resource);
+
+            KeyTable(const KeyTable& other) = delete;
+            KeyTable& operator=(const KeyTable& other) = delete;
+
+            [[nodiscard]] static size_t hashKey(std::string_view text);
+
+            /// @brief Returns the key for text, storing it on first sight.
+            [[nodiscard]] Key intern(std::string_view text);
+
+            /// @param hash Must be hashKey(text), for callers that already have it.
+            [[nodiscard]] Key intern(std::string_view text, size_t hash);
+
+            /// @brief Returns the key for text, or nullptr if it was never interned. Never stores anything.
+            [[nodiscard]] Key lookup(std::string_view text) const;
+
+            [[nodiscard]] size_t getSize() const;
+
+        private:
+            mutable std::mutex table_lock;
+            std::pmr::monotonic_buffer_resource storage;
+            std::pmr::vector<Key> slots; // nullptr marks an empty slot
+            size_t count;
+
+            [[nodiscard]] size_t findSlot(std::string_view text, size_t hash) const;
+            void grow();
+    };
+}
+
+#endif
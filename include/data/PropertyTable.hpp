@@ -0,0 +1,86 @@
+#ifndef PROPERTY_TABLE_HPP
+#define PROPERTY_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+#include "data/IValue.hpp"
+#include "data/KeyTable.hpp"
+
+namespace toyjson::data {
+    /// @brief What an object does when a key repeats.
+    enum class DuplicateKeyPolicy : std::uint8_t {
+        keep_last,  // later values replace earlier ones, and the key keeps its first position
+        keep_first, // later values are dropped
+        reject      // parsing fails with ParseStatus::err_duplicate_key
+    };
+
+    struct Property {
+        Key key;
+        std::shared_ptr<IJsonValue> value;
+    };
+
+    /**
+     * @brief Object members in one contiguous array kept in insertion order. Small tables are searched linearly, and past hash_threshold members an open-addressing index of member positions is kept alongside.
+     * @note Keys are interned in a KeyTable shared with the rest of the document. Lookups take either std::string_view, or a Key from getKeyTable() to compare by address alone.
+     */
+    class PropertyTable {
+        public:
+            using const_iterator = std::pmr::vector<Property>::const_iterator;
+
+            static constexpr size_t hash_threshold = 16;
+
+            /// @note Makes its own KeyTable on the first string insert.
+            PropertyTable();
+            PropertyTable(std::shared_ptr<KeyTable> x_keys, std::pmr::memory_resource* resource);
+
+            /**
+             * @brief Adds a member, resolving a repeated key by the policy.
+             * @param key Must come from getKeyTable().
+             * @return false only if the key repeats under DuplicateKeyPolicy::reject. Nothing is changed then.
+             */
+            bool insert(Key key, std::shared_ptr<IJsonValue> value, DuplicateKeyPolicy policy);
+
+            /// @brief Interns key first, then inserts as above.
+            bool insert(std::string_view key, std::shared_ptr<IJsonValue> value, DuplicateKeyPolicy policy);
+
+            /**
+             * @brief Moves every member of other in after this table's own, in order, as if each were inserted here. other is left empty.
+             * @note Keys are re-interned only when other uses a different KeyTable.
+             * @return false if a key repeated under DuplicateKeyPolicy::reject. The tables are partly merged then.
+             */
+            bool merge(PropertyTable& other, DuplicateKeyPolicy policy);
+
+            void reserve(size_t count);
+
+            [[nodiscard]] const Property* find(std::string_view key) const;
+
+            /// @note Compares addresses only, so a Key from any other table is never found.
+            [[nodiscard]] const Property* find(Key key) const;
+
+            /// @note Tables built in an arena do not own their KeyTable, so this is only valid while the document lives.
+            [[nodiscard]] const std::shared_ptr<KeyTable>& getKeyTable() const;
+
+            [[nodiscard]] bool isEmpty() const;
+            [[nodiscard]] size_t getSize() const;
+
+            [[nodiscard]] const_iterator begin() const;
+            [[nodiscard]] const_iterator end() const;
+
+        private:
+            std::shared_ptr<KeyTable> keys;
+            std::pmr::vector<Property> members;
+            std::pmr::vector<std::uint32_t> slots; // member position + 1, or 0 for an empty slot
+
+            /// @note These return the member position, or npos.
+            [[nodiscard]] size_t findPosition(std::string_view key) const;
+            [[nodiscard]] size_t findPosition(Key key) const;
+            void rebuildIndex(size_t slot_count);
+            void indexMember(size_t member_pos);
+    };
+}
+
+#endif
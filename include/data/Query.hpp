@@ -0,0 +1,339 @@
+#ifndef QUERY_HPP
+#define QUERY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "data/Tape.hpp"
+#include "data/Value.hpp"
+
+namespace toyjson::data {
+    enum class PathStepKind : std::uint8_t {
+        member,   // object key, which a JSON Pointer token that reads as an index also applies to arrays by
+        index,    // array item, counting from the end if negative
+        wildcard, // every array item or object member value
+        slice     // array items from start up to end by stride, as Python slices them
+    };
+
+    struct PathStep {
+        PathStepKind kind;
+        std::string name;   // unescaped member name
+        std::int64_t index; // item position, or -1 for a member step that cannot address items
+        std::int64_t start;
+        std::int64_t end;
+        std::int64_t stride;
+        bool has_start;
+        bool has_end;
+
+        [[nodiscard]] bool operator==(const PathStep& other) const = default;
+    };
+
+    class QueryBatch;
+
+    /**
+     * @brief A JSON Pointer (RFC 6901) or JSONPath subset compiled once into steps, then run against any number of documents.
+     * @note Running never allocates or copies: matches are handed out as views into the document, valid while it lives. Tree and tape documents are both supported.
+     */
+    class PathQuery {
+        public:
+            PathQuery() = delete;
+
+            /// @throws std::runtime_error for a pointer that is neither empty nor starts with '/', or holds a bad "~" escape.
+            [[nodiscard]] static PathQuery compilePointer(std::string_view pointer);
+
+            /**
+             * @brief Compiles "$" followed by .name, ['name'], [index], [*], .* or [start:end:stride] steps.
+             * @throws std::runtime_error for anything else, including recursive descent and filters.
+             */
+            [[nodiscard]] static PathQuery compilePath(std::string_view path);
+
+            [[nodiscard]] const std::vector<PathStep>& getSteps() const;
+
+            /// @brief True if the query can match at most one value, having no wildcard or slice.
+            [[nodiscard]] bool isSingular() const;
+
+            /// @brief Returns the first match in document order, or nullptr.
+            [[nodiscard]] const IJsonValue* find(const IJsonValue& root) const;
+            [[nodiscard]] std::optional<TapeValue> find(TapeValue root) const;
+
+            /**
+             * @brief Calls fn with each match in document order. fn may return false to stop early.
+             * @return Count of matches passed to fn.
+             */
+            template <typename Fn>
+            size_t forEach(const IJsonValue& root, Fn&& fn) const;
+
+            template <typename Fn>
+            size_t forEach(TapeValue root, Fn&& fn) const;
+
+        private:
+            friend class QueryBatch;
+
+            std::vector<PathStep> steps;
+
+            explicit PathQuery(std::vector<PathStep> x_steps);
+
+            [[nodiscard]] static const ArrayField* asArray(const IJsonValue* value);
+            [[nodiscard]] static const ObjectField* asObject(const IJsonValue* value);
+
+            /// @brief Resolves a possibly negative index against a length. Returns npos if out of range.
+            [[nodiscard]] static size_t resolveIndex(std::int64_t index, size_t length);
+
+            /// @brief Clamps a slice to a length. Positions run from first while not equal to last, in stride steps.
+            static void resolveSlice(const PathStep& step, size_t length, std::int64_t& first, std::int64_t& last);
+
+            /// @note Each applyStep calls fn(child) for every value the step selects, and returns false once fn does.
+            template <typename Fn>
+            static bool applyStep(const PathStep& step, const IJsonValue* value, Fn& fn);
+
+            template <typename Fn>
+            static bool applyStep(const PathStep& step, TapeValue value, Fn& fn);
+
+            template <typename Value, typename Fn>
+            [[nodiscard]] bool walk(size_t step_pos, Value value, Fn& fn, size_t& matched) const;
+
+            template <typename Fn, typename Arg>
+            static bool invokeMatch(Fn& fn, Arg&& arg);
+    };
+
+    /**
+     * @brief Runs many queries in one pass. Queries are merged into a trie, so steps they share are walked once.
+     */
+    class QueryBatch {
+        public:
+            QueryBatch();
+
+            /// @return The query's id, counting from 0 in the order added.
+            size_t add(const PathQuery& query);
+
+            [[nodiscard]] size_t getQueryCount() const;
+
+            /// @brief Calls fn(query_id, match) for each match of each query. Matches of one query arrive in document order.
+            template <typename Fn>
+            void run(const IJsonValue& root, Fn&& fn) const;
+
+            template <typename Fn>
+            void run(TapeValue root, Fn&& fn) const;
+
+        private:
+            struct TrieNode {
+                PathStep step;
+                std::vector<std::uint32_t> children;
+                std::vector<std::uint32_t> query_ids;
+            };
+
+            std::vector<TrieNode> nodes; // nodes[0] is the root, whose step is unused
+            size_t query_count;
+
+            template <typename Value, typename Fn>
+            void runNode(std::uint32_t node_pos, Value value, Fn& fn) const;
+    };
+
+    /* PathQuery impl. */
+
+    template <typename Fn>
+    size_t PathQuery::forEach(const IJsonValue& root, Fn&& fn) const {
+        size_t matched = 0;
+        auto visit = [&fn](const IJsonValue* match) { return invokeMatch(fn, *match); };
+
+        (void)walk(0, &root, visit, matched);
+
+        return matched;
+    }
+
+    template <typename Fn>
+    size_t PathQuery::forEach(TapeValue root, Fn&& fn) const {
+        size_t matched = 0;
+        auto visit = [&fn](TapeValue match) { return invokeMatch(fn, match); };
+
+        (void)walk(0, root, visit, matched);
+
+        return matched;
+    }
+
+    template <typename Fn>
+    bool PathQuery::applyStep(const PathStep& step, const IJsonValue* value, Fn& fn) {
+        if (const ObjectField* object = asObject(value); object != nullptr) {
+            if (step.kind == PathStepKind::member) {
+                const Property* member = object->getProperties().find(step.name);
+
+                return member == nullptr || fn(member->value.get());
+            } else if (step.kind == PathStepKind::wildcard) {
+                for (const auto& member : object->getProperties()) {
+                    if (!fn(member.value.get()))
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        const ArrayField* array = asArray(value);
+
+        if (array == nullptr)
+            return true;
+
+        size_t length = array->getLength();
+
+        if (step.kind == PathStepKind::wildcard) {
+            for (size_t pos = 0; pos < length; pos++) {
+                if (!fn(array->getItemPtr(pos).get()))
+                    return false;
+            }
+        } else if (step.kind == PathStepKind::slice) {
+            std::int64_t first = 0;
+            std::int64_t last = 0;
+
+            resolveSlice(step, length, first, last);
+
+            for (std::int64_t pos = first; pos != last; pos += step.stride) {
+                if (!fn(array->getItemPtr(static_cast<size_t>(pos)).get()))
+                    return false;
+            }
+        } else if (step.index >= 0 || step.kind == PathStepKind::index) {
+            size_t pos = resolveIndex(step.index, length);
+
+            return pos == std::string_view::npos || fn(array->getItemPtr(pos).get());
+        }
+
+        return true;
+    }
+
+    /// @note Tape children are reached by walking siblings, so index and slice steps cost time linear in the positions they pass.
+    template <typename Fn>
+    bool PathQuery::applyStep(const PathStep& step, TapeValue value, Fn& fn) {
+        JsonType type = value.getType();
+
+        if (type == JsonType::j_object) {
+            if (value.isEmpty() || (step.kind != PathStepKind::member && step.kind != PathStepKind::wildcard))
+                return true;
+
+            TapeValue key = value.getFirstChild();
+            TapeValue match = value;
+            bool matched = false;
+
+            for (size_t member = 0; member < value.getPropertyCount(); member++) {
+                TapeValue item = key.getNextSibling();
+
+                // The last match wins, as in TapeValue::getValuePtr, so keep scanning past earlier ones.
+                if (step.kind == PathStepKind::member && key.asString() == step.name) {
+                    match = item;
+                    matched = true;
+                }
+
+                if (step.kind == PathStepKind::wildcard && !fn(item))
+                    return false;
+
+                key = item.getNextSibling();
+            }
+
+            return !matched || fn(match);
+        }
+
+        if (type != JsonType::j_array || value.isEmpty())
+            return true;
+
+        size_t length = value.getLength();
+
+        if (step.kind == PathStepKind::wildcard) {
+            TapeValue item = value.getFirstChild();
+
+            for (size_t pos = 0; pos < length; pos++, item = item.getNextSibling()) {
+                if (!fn(item))
+                    return false;
+            }
+        } else if (step.kind == PathStepKind::slice) {
+            std::int64_t first = 0;
+            std::int64_t last = 0;
+
+            resolveSlice(step, length, first, last);
+
+            if (step.stride < 0) {
+                for (std::int64_t pos = first; pos != last; pos += step.stride) {
+                    if (!fn(value.getItemPtr(static_cast<size_t>(pos))))
+                        return false;
+                }
+
+                return true;
+            }
+
+            TapeValue item = value.getFirstChild();
+            std::int64_t item_pos = 0;
+
+            for (std::int64_t pos = first; pos != last; pos += step.stride) {
+                for (; item_pos < pos; item_pos++)
+                    item = item.getNextSibling();
+
+                if (!fn(item))
+                    return false;
+            }
+        } else if (step.index >= 0 || step.kind == PathStepKind::index) {
+            size_t pos = resolveIndex(step.index, length);
+
+            return pos == std::string_view::npos || fn(value.getItemPtr(pos));
+        }
+
+        return true;
+    }
+
+    template <typename Value, typename Fn>
+    bool PathQuery::walk(size_t step_pos, Value value, Fn& fn, size_t& matched) const {
+        if (step_pos == steps.size()) {
+            matched++;
+            return fn(value);
+        }
+
+        auto descend = [this, step_pos, &fn, &matched](Value child) { return walk(step_pos + 1, child, fn, matched); };
+
+        return applyStep(steps[step_pos], value, descend);
+    }
+
+    template <typename Fn, typename Arg>
+    bool PathQuery::invokeMatch(Fn& fn, Arg&& arg) {
+        if constexpr (std::is_void_v<std::invoke_result_t<Fn&, Arg>>) {
+            fn(std::forward<Arg>(arg));
+            return true;
+        } else {
+            return static_cast<bool>(fn(std::forward<Arg>(arg)));
+        }
+    }
+
+    /* QueryBatch impl. */
+
+    template <typename Fn>
+    void QueryBatch::run(const IJsonValue& root, Fn&& fn) const {
+        auto visit = [&fn](std::uint32_t query_id, const IJsonValue* match) { fn(static_cast<size_t>(query_id), *match); };
+
+        runNode(0, &root, visit);
+    }
+
+    template <typename Fn>
+    void QueryBatch::run(TapeValue root, Fn&& fn) const {
+        auto visit = [&fn](std::uint32_t query_id, TapeValue match) { fn(static_cast<size_t>(query_id), match); };
+
+        runNode(0, root, visit);
+    }
+
+    template <typename Value, typename Fn>
+    void QueryBatch::runNode(std::uint32_t node_pos, Value value, Fn& fn) const {
+        const TrieNode& node = nodes[node_pos];
+
+        for (std::uint32_t query_id : node.query_ids)
+            fn(query_id, value);
+
+        for (std::uint32_t child_pos : node.children) {
+            auto descend = [this, child_pos, &fn](Value child) {
+                runNode(child_pos, child, fn);
+                return true;
+            };
+
+            (void)PathQuery::applyStep(nodes[child_pos].step, value, descend);
+        }
+    }
+}
+
+#endif
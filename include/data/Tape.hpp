@@ -0,0 +1,155 @@
+#ifndef TAPE_HPP
+#define TAPE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "data/IValue.hpp"
+
+namespace toyjson::data {
+    /**
+     * @brief One 16-byte slot of a flattened JSON document. Scalars live inline and containers store the tape index just past their last descendant, so a whole subtree can be skipped in O(1).
+     */
+    struct TapeNode {
+        JsonType type;
+        std::uint8_t flags;    // NumberKind for numbers, plus the tape_*_bit markers
+        std::uint32_t length;  // child count for containers, byte count for strings and lazy numbers
+        std::uint64_t payload; // boolean, number bits, string offset, or container end index
+    };
+
+    inline constexpr std::uint8_t tape_kind_mask = 0x03;
+
+    /// @brief The payload is an offset into the source text rather than the string pool or the number bits.
+    inline constexpr std::uint8_t tape_lazy_bit = 0x10;
+
+    /// @brief A lazy string whose source span still holds escapes.
+    inline constexpr std::uint8_t tape_escaped_bit = 0x20;
+
+    /**
+     * @brief Conversion hooks for lazy scalars, supplied by whichever frontend produced the tape.
+     */
+    struct ScalarCodec {
+        bool (*decode_string)(std::string_view raw, std::string& out);
+        bool (*convert_number)(std::string_view lexeme, NumberKind& kind, std::uint64_t& bits);
+    };
+
+    /// @brief Nodes, strings and decode memo behind a JsonTape. Kept on the heap, so values stay valid when the tape or its document is moved.
+    struct TapeState;
+
+    /**
+     * @brief Read-only handle to one value on a tape. Cheap to copy, and only valid while the owning tape lives.
+     */
+    class TapeValue {
+        public:
+            TapeValue() = delete;
+            TapeValue(const TapeState* x_state, std::uint32_t x_index);
+
+            [[nodiscard]] JsonType getType() const;
+
+            [[nodiscard]] bool asBoolean() const;
+            [[nodiscard]] double asNumber() const;
+            [[nodiscard]] NumberKind getNumberKind() const;
+            [[nodiscard]] std::int64_t asInt64() const;
+            [[nodiscard]] std::uint64_t asUInt64() const;
+            [[nodiscard]] std::string_view asString() const;
+
+            [[nodiscard]] bool isEmpty() const;
+            [[nodiscard]] size_t getLength() const;
+            [[nodiscard]] size_t getPropertyCount() const;
+
+            [[nodiscard]] TapeValue getItemPtr(size_t pos) const;
+
+            [[nodiscard]] bool hasProperty(std::string_view key) const;
+
+            /// @note A repeated key yields its last value, as trees do by default. Tapes keep every member though, so getPropertyCount() and child walks still see each repeat.
+            [[nodiscard]] TapeValue getValuePtr(std::string_view key) const;
+
+            /// @brief An array's first item, or an object's first key, read with asString() and followed by its member's value. Only for non-empty containers.
+            [[nodiscard]] TapeValue getFirstChild() const;
+
+            /// @brief The value just past this one and its subtree, so a container's children can be walked in O(1) steps.
+            [[nodiscard]] TapeValue getNextSibling() const;
+
+        private:
+            const TapeState* state;
+            std::uint32_t index;
+
+            [[nodiscard]] const TapeNode& getNode() const;
+            [[nodiscard]] std::uint32_t findProperty(std::string_view key) const;
+            void loadNumber(NumberKind& kind, std::uint64_t& bits) const;
+    };
+
+    /**
+     * @brief Owns a flattened document: one contiguous node array plus one string pool, so teardown is a fixed few frees no matter the document size.
+     * @note Lazy tapes also view the source text, and mapped tapes view their nodes and strings in place. The owning ToyJsonDocument keeps either alive.
+     */
+    class JsonTape {
+        public:
+            JsonTape();
+            JsonTape(std::vector<TapeNode> x_nodes, std::string x_strings);
+            JsonTape(std::vector<TapeNode> x_nodes, std::string x_strings, std::string_view x_source, const ScalarCodec* x_codec);
+
+            /// @brief Views nodes and strings stored elsewhere, such as a mapped snapshot, without copying them. Nodes may not be lazy.
+            JsonTape(std::span<const TapeNode> x_mapped_nodes, std::string_view x_mapped_strings);
+
+            [[nodiscard]] bool isEmpty() const;
+            [[nodiscard]] size_t getNodeCount() const;
+
+            /// @brief True if some nodes may still point into source text instead of the string pool.
+            [[nodiscard]] bool isLazy() const;
+
+            /// @brief The raw node array and string pool, for writers of binary snapshots.
+            [[nodiscard]] std::span<const TapeNode> getNodes() const;
+            [[nodiscard]] std::string_view getStringPool() const;
+
+            [[nodiscard]] TapeValue getRoot() const;
+
+        private:
+            std::shared_ptr<const TapeState> state; // null for an empty tape; copies share it
+    };
+
+    /**
+     * @brief Appends values to a tape in document order. Object members are pushed as a key followed by its value.
+     */
+    class TapeBuilder {
+        public:
+            TapeBuilder();
+
+            void pushNull();
+            void pushBoolean(bool flag);
+            void pushNumber(double num);
+            void pushNumber(std::int64_t num);
+            void pushNumber(std::uint64_t num);
+            void pushString(std::string_view str);
+            void pushKey(std::string_view key);
+
+            /// @note Lazy pushes record source spans only. Use release(source, codec) with the same source afterwards.
+            void pushLazyNumber(size_t offset, size_t length);
+            void pushLazyString(size_t offset, size_t length, bool escaped);
+            void pushLazyKey(size_t offset, size_t length);
+
+            void beginArray();
+            void endArray();
+            void beginObject();
+            void endObject();
+
+            [[nodiscard]] JsonTape release();
+            [[nodiscard]] JsonTape release(std::string_view source, const ScalarCodec* codec);
+
+        private:
+            std::vector<TapeNode> nodes;
+            std::string strings;
+            std::vector<std::uint32_t> open_stack;
+
+            void pushNumberBits(NumberKind kind, std::uint64_t bits);
+            void pushContainer(JsonType type);
+            void closeContainer();
+            void countChild();
+            void countMember();
+    };
+}
+
+#endif
@@ -2,16 +2,27 @@
 #define VALUE_HPP
 
 #include <any>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <map>
+#include <stdexcept>
+#include <memory_resource>
 #include <variant>
 #include <vector>
 #include <string_view>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <memory>
 #include "data/IValue.hpp"
+#include "data/PropertyTable.hpp"
+#include "data/Tape.hpp"
 
 namespace toyjson::data {
+    /// @note Containers are polymorphic-allocator aware so a Parser can back a whole tree with one arena.
+    using ItemList = std::pmr::vector<std::shared_ptr<IJsonValue>>;
+
     class NullField : public IJsonValue {
         public:
             NullField() = default;
@@ -31,6 +42,8 @@ namespace toyjson::data {
             [[nodiscard]] JsonType getType() const override;
             [[nodiscard]] std::any toBoxedValue() const override;
 
+            [[nodiscard]] bool asBoolean() const;
+
         private:
             bool value;
     };
@@ -39,31 +52,92 @@ namespace toyjson::data {
         public:
             NumberField() = delete;
             NumberField(double num);
+            NumberField(int num);
+            NumberField(std::int64_t num);
+            NumberField(std::uint64_t num);
 
             [[nodiscard]] JsonType getType() const override;
+
+            /// @note Always boxes a double, even for integral numbers. Use asInt64() or asUInt64() for exact values.
             [[nodiscard]] std::any toBoxedValue() const override;
 
+            [[nodiscard]] NumberKind getNumberKind() const;
+            [[nodiscard]] bool isIntegral() const;
+
+            [[nodiscard]] double asDouble() const;
+            [[nodiscard]] std::int64_t asInt64() const;
+            [[nodiscard]] std::uint64_t asUInt64() const;
+
         private:
-            double value;
+            union NumberBits {
+                double real;
+                std::int64_t signed_whole;
+                std::uint64_t unsigned_whole;
+            };
+
+            NumberBits value;
+            NumberKind kind;
     };
 
     class StringField : public IJsonValue {
         public:
             StringField() = delete;
             StringField(std::string x_str);
+            StringField(std::pmr::string x_str);
 
             [[nodiscard]] JsonType getType() const override;
             [[nodiscard]] std::any toBoxedValue() const override;
+
+            /// @brief Views the text in place. No copy.
+            [[nodiscard]] std::string_view asString() const;
         private:
-            std::string value;
+            std::pmr::string value;
     };
 
     class ArrayField : public IJsonValue {
         public:
             ArrayField();
             ArrayField(std::vector<std::shared_ptr<IJsonValue>> x_items);
+            ArrayField(ItemList x_items);
+
+            /// @brief Iterates items as `const IJsonValue&`, so range-for needs no pointer handling.
+            class Iterator {
+                public:
+                    using iterator_category = std::random_access_iterator_tag;
+                    using value_type = IJsonValue;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = const IJsonValue*;
+                    using reference = const IJsonValue&;
+
+                    Iterator() = default;
+                    explicit Iterator(ItemList::const_iterator x_pos)
+                        : pos {x_pos} {}
+
+                    [[nodiscard]] reference operator*() const { return **pos; }
+                    [[nodiscard]] pointer operator->() const { return pos->get(); }
+                    [[nodiscard]] reference operator[](difference_type offset) const { return *pos[offset]; }
+
+                    Iterator& operator++() { ++pos; return *this; }
+                    Iterator operator++(int) { return Iterator {pos++}; }
+                    Iterator& operator--() { --pos; return *this; }
+                    Iterator operator--(int) { return Iterator {pos--}; }
+                    Iterator& operator+=(difference_type offset) { pos += offset; return *this; }
+                    Iterator& operator-=(difference_type offset) { pos -= offset; return *this; }
+
+                    [[nodiscard]] friend Iterator operator+(Iterator iter, difference_type offset) { return iter += offset; }
+                    [[nodiscard]] friend Iterator operator+(difference_type offset, Iterator iter) { return iter += offset; }
+                    [[nodiscard]] friend Iterator operator-(Iterator iter, difference_type offset) { return iter -= offset; }
+                    [[nodiscard]] friend difference_type operator-(const Iterator& lhs, const Iterator& rhs) { return lhs.pos - rhs.pos; }
+                    [[nodiscard]] friend bool operator==(const Iterator& lhs, const Iterator& rhs) = default;
+                    [[nodiscard]] friend auto operator<=>(const Iterator& lhs, const Iterator& rhs) = default;
+
+                private:
+                    ItemList::const_iterator pos;
+            };
 
             [[nodiscard]] JsonType getType() const override;
+
+            /// @brief Boxes a `const ArrayField*` to this array. The items are never copied.
             [[nodiscard]] std::any toBoxedValue() const override;
 
             [[nodiscard]] bool isEmpty() const;
@@ -71,26 +145,49 @@ namespace toyjson::data {
 
             [[nodiscard]] const std::shared_ptr<IJsonValue>& getItemPtr(size_t pos) const;
 
+            /// @throws std::out_of_range past the last item.
+            [[nodiscard]] const IJsonValue& at(size_t pos) const;
+
+            [[nodiscard]] Iterator begin() const;
+            [[nodiscard]] Iterator end() const;
+
         private:
-            std::vector<std::shared_ptr<IJsonValue>> value;
+            ItemList value;
     };
 
     class ObjectField : public IJsonValue {
         public:
             ObjectField();
             ObjectField(std::map<std::string, std::shared_ptr<IJsonValue>> x_map);
+            ObjectField(PropertyTable x_table);
 
             [[nodiscard]] JsonType getType() const override;
+
+            /// @brief Boxes a `const ObjectField*` to this object. The members are never copied.
             [[nodiscard]] std::any toBoxedValue() const override;
 
             [[nodiscard]] bool isEmpty() const;
             [[nodiscard]] size_t getPropertyCount() const;
 
-            [[nodiscard]] bool hasProperty(const std::string& key) const;
-            [[nodiscard]] const std::shared_ptr<IJsonValue>& getValuePtr(const std::string& key) const;
+            [[nodiscard]] bool hasProperty(std::string_view key) const;
+            [[nodiscard]] const std::shared_ptr<IJsonValue>& getValuePtr(std::string_view key) const;
+
+            /// @note Key must come from getProperties().getKeyTable(). The search then compares addresses only.
+            [[nodiscard]] bool hasProperty(Key key) const;
+            [[nodiscard]] const std::shared_ptr<IJsonValue>& getValuePtr(Key key) const;
+
+            /// @brief Members in source order.
+            [[nodiscard]] const PropertyTable& getProperties() const;
+
+            /// @throws std::out_of_range if there is no such member.
+            [[nodiscard]] const IJsonValue& at(std::string_view key) const;
+
+            /// @brief Iterates members in source order, as Property entries.
+            [[nodiscard]] PropertyTable::const_iterator begin() const;
+            [[nodiscard]] PropertyTable::const_iterator end() const;
 
         private:
-            std::map<std::string, std::shared_ptr<IJsonValue>> value;
+            PropertyTable value;
     };
 
     /* Type Utility */
@@ -125,8 +222,13 @@ namespace toyjson::data {
             AnyField(ObjectField x_object);
 
             [[nodiscard]] JsonType getType() const override;
+
+            /// @warning Boxes a copy of the whole wrapped value, containers included, so `std::any_cast<AnyField>` keeps working. Prefer IJsonValue::as() or visit(), which never copy.
             [[nodiscard]] std::any toBoxedValue() const override;
 
+            /// @brief Returns the type of the wrapped value, where getType() is always JsonType::j_any.
+            [[nodiscard]] JsonType getValueType() const;
+
             template <typename Ntv>
             constexpr const Ntv& unpackValue()
             {
@@ -134,20 +236,114 @@ namespace toyjson::data {
 
                 return std::get<variant_pos>(value);
             }
+
+            template <typename Ntv>
+            constexpr const Ntv& unpackValue() const
+            {
+                constexpr int variant_pos = toAnyVariantPos<Ntv>();
+
+                return std::get<variant_pos>(value);
+            }
+
+            /// @brief Views the wrapped value if it is an Ntv, else returns nullptr.
+            template <typename Ntv>
+            [[nodiscard]] const Ntv* peekValue() const
+            {
+                return std::get_if<Ntv>(&value);
+            }
+
+            template <typename Fn>
+            decltype(auto) visitValue(Fn&& fn) const
+            {
+                return std::visit(std::forward<Fn>(fn), value);
+            }
         private:
             std::variant<NullField, BooleanField, NumberField, StringField, ArrayField, ObjectField> value;
     };
 
+    /* IJsonValue access impl. */
+
+    template <typename Field>
+    const Field* IJsonValue::getIf() const {
+        static_assert(std::is_same_v<Field, NullField> || toAnyVariantPos<Field>() != 0, "getIf() takes a concrete field type");
+
+        JsonType type = getType();
+
+        if (type == JsonType::j_any)
+            return static_cast<const AnyField*>(this)->peekValue<Field>();
+
+        // Variant positions follow JsonType order, so they double as the field's type tag.
+        if (type == static_cast<JsonType>(toAnyVariantPos<Field>()))
+            return static_cast<const Field*>(this);
+
+        return nullptr;
+    }
+
+    template <typename Field>
+    const Field& IJsonValue::as() const {
+        const Field* field = getIf<Field>();
+
+        if (field == nullptr)
+            throw std::runtime_error {"JSON value does not hold the requested type"};
+
+        return *field;
+    }
+
+    template <typename Fn>
+    decltype(auto) IJsonValue::visit(Fn&& fn) const {
+        switch (getType()) {
+            case JsonType::j_any:
+                return static_cast<const AnyField*>(this)->visitValue(std::forward<Fn>(fn));
+            case JsonType::j_null:
+                return std::forward<Fn>(fn)(static_cast<const NullField&>(*this));
+            case JsonType::j_boolean:
+                return std::forward<Fn>(fn)(static_cast<const BooleanField&>(*this));
+            case JsonType::j_number:
+                return std::forward<Fn>(fn)(static_cast<const NumberField&>(*this));
+            case JsonType::j_string:
+                return std::forward<Fn>(fn)(static_cast<const StringField&>(*this));
+            case JsonType::j_array:
+                return std::forward<Fn>(fn)(static_cast<const ArrayField&>(*this));
+            default:
+                return std::forward<Fn>(fn)(static_cast<const ObjectField&>(*this));
+        }
+    }
+
+    enum class StorageMode {
+        tree,
+        tape
+    };
+
     class ToyJsonDocument {
         public:
             ToyJsonDocument();
             ToyJsonDocument(const std::string& name_str, std::shared_ptr<IJsonValue> x_root_ptr);
+            ToyJsonDocument(const std::string& name_str, std::shared_ptr<IJsonValue> x_root_ptr, std::shared_ptr<std::pmr::memory_resource> x_arena_ptr);
+
+            /// @param x_keys_ptr Owner of a shared KeyTable that arena nodes only point into. It lives as long as the document.
+            ToyJsonDocument(const std::string& name_str, std::shared_ptr<IJsonValue> x_root_ptr, std::shared_ptr<std::pmr::memory_resource> x_arena_ptr, std::shared_ptr<const void> x_keys_ptr);
+            ToyJsonDocument(const std::string& name_str, JsonTape x_tape);
+
+            /// @param x_source_ptr Owner of the text a lazy tape views into. It lives as long as the document.
+            ToyJsonDocument(const std::string& name_str, JsonTape x_tape, std::shared_ptr<const void> x_source_ptr);
 
             [[nodiscard]] std::string_view getTitle() const;
+            [[nodiscard]] StorageMode getStorageMode() const;
+
+            /// @note Only set for StorageMode::tree documents.
             [[nodiscard]] const std::shared_ptr<IJsonValue>& getRoot() const;
 
+            /// @note Only filled for StorageMode::tape documents.
+            [[nodiscard]] const JsonTape& getTape() const;
+
         private:
             std::string title;
+            std::shared_ptr<const void> source_ptr; // source text or key table the document views into
+            JsonTape tape;
+            StorageMode mode;
+
+            /// @note Declared before root_ptr so the arena outlives every node allocated from it.
+            std::shared_ptr<std::pmr::memory_resource> arena_ptr;
 
             /// @warning Only store AnyField objects or else there's no guarantee of the IJsonValue having a desired value within.
             std::shared_ptr<IJsonValue> root_ptr;
@@ -0,0 +1,159 @@
+#ifndef BINDING_HPP
+#define BINDING_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace toyjson::frontend {
+    /// @brief One bound member: the JSON key it reads from and where it goes.
+    template <typename Owner, typename Member>
+    struct FieldBinding {
+        using owner_type = Owner;
+        using member_type = Member;
+
+        std::string_view name;
+        Member Owner::* member;
+    };
+
+    template <typename Owner, typename Member>
+    [[nodiscard]] constexpr FieldBinding<Owner, Member> bindField(std::string_view name, Member Owner::* member) {
+        return FieldBinding<Owner, Member> {name, member};
+    }
+
+    /**
+     * @brief Specialize with a static constexpr `list` tuple of bindField() entries to let Parser::parseInto fill a struct directly:
+     *  template <> struct JsonFields<Point> { static constexpr auto list = std::make_tuple(bindField("x", &Point::x), bindField("y", &Point::y)); };
+     * @note Members may be bool, arithmetic, std::string, other bound structs, or std::vector, std::optional and std::map<std::string, ...> of those.
+     */
+    template <typename T>
+    struct JsonFields;
+
+    template <typename T>
+    concept BoundObject = requires {
+        { std::tuple_size<std::remove_cvref_t<decltype(JsonFields<T>::list)>>::value } -> std::convertible_to<size_t>;
+    };
+
+    /* Binding type traits */
+
+    template <typename T>
+    struct IsVector : std::false_type {};
+
+    template <typename Item, typename Alloc>
+    struct IsVector<std::vector<Item, Alloc>> : std::true_type {};
+
+    template <typename T>
+    struct IsOptional : std::false_type {};
+
+    template <typename Item>
+    struct IsOptional<std::optional<Item>> : std::true_type {};
+
+    template <typename T>
+    struct IsStringMap : std::false_type {};
+
+    template <typename Item, typename Compare, typename Alloc>
+    struct IsStringMap<std::map<std::string, Item, Compare, Alloc>> : std::true_type {};
+
+    /**
+     * @brief Key lookup table built at compile time from a bound struct's names. A seed is searched for that spreads the names over distinct slots, so a lookup is usually one hash, one length check and one compare.
+     * @note Falls back to linear probing when no seed in range is perfect, so any set of distinct names works.
+     */
+    template <size_t Count>
+    struct KeyIndex {
+        static constexpr size_t capacity = std::bit_ceil(Count * 2 + 1);
+        static constexpr size_t npos = static_cast<size_t>(-1);
+        static constexpr std::uint64_t max_seed = 256;
+
+        std::array<std::string_view, Count> names;
+        std::array<std::uint16_t, capacity> slots; // field position + 1, or 0 if empty
+        std::uint64_t seed;
+
+        [[nodiscard]] static constexpr size_t hashKey(std::string_view key, std::uint64_t x_seed) {
+            std::uint64_t hash = 14695981039346656037ULL ^ (x_seed * 0x9E3779B97F4A7C15ULL);
+
+            for (char c : key) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ULL;
+            }
+
+            return static_cast<size_t>(hash ^ (hash >> 29));
+        }
+
+        /// @return The position of the field named key, or npos.
+        [[nodiscard]] constexpr size_t find(std::string_view key) const {
+            for (size_t slot = hashKey(key, seed) & (capacity - 1); slots[slot] != 0; slot = (slot + 1) & (capacity - 1)) {
+                size_t field_pos = slots[slot] - 1U;
+
+                if (names[field_pos].length() == key.length() && names[field_pos] == key)
+                    return field_pos;
+            }
+
+            return npos;
+        }
+    };
+
+    /// @brief Total probe distance of names placed under a seed. 0 means every name landed in its home slot.
+    template <size_t Count>
+    constexpr size_t fillKeyIndex(KeyIndex<Count>& index, std::uint64_t x_seed) {
+        constexpr size_t mask = KeyIndex<Count>::capacity - 1;
+        size_t displacement = 0;
+
+        index.seed = x_seed;
+        index.slots.fill(0);
+
+        for (size_t field_pos = 0; field_pos < Count; field_pos++) {
+            size_t slot = KeyIndex<Count>::hashKey(index.names[field_pos], x_seed) & mask;
+
+            for (; index.slots[slot] != 0; slot = (slot + 1) & mask)
+                displacement++;
+
+            index.slots[slot] = static_cast<std::uint16_t>(field_pos + 1);
+        }
+
+        return displacement;
+    }
+
+    template <size_t Count>
+    [[nodiscard]] constexpr KeyIndex<Count> makeKeyIndex(const std::array<std::string_view, Count>& names) {
+        KeyIndex<Count> index {names, {}, 0};
+
+        for (size_t lhs = 0; lhs < Count; lhs++) {
+            for (size_t rhs = lhs + 1; rhs < Count; rhs++) {
+                if (names[lhs] == names[rhs])
+                    throw "Bound struct repeats a JSON field name";
+            }
+        }
+
+        std::uint64_t best_seed = 0;
+        size_t best_displacement = static_cast<size_t>(-1);
+
+        for (std::uint64_t x_seed = 0; x_seed < KeyIndex<Count>::max_seed && best_displacement != 0; x_seed++) {
+            if (size_t displacement = fillKeyIndex(index, x_seed); displacement < best_displacement) {
+                best_displacement = displacement;
+                best_seed = x_seed;
+            }
+        }
+
+        fillKeyIndex(index, best_seed);
+
+        return index;
+    }
+
+    template <BoundObject T>
+    inline constexpr size_t field_count = std::tuple_size_v<std::remove_cvref_t<decltype(JsonFields<T>::list)>>;
+
+    template <BoundObject T>
+    inline constexpr auto field_index = []<size_t... Ids>(std::index_sequence<Ids...>) {
+        return makeKeyIndex(std::array<std::string_view, sizeof...(Ids)> {std::get<Ids>(JsonFields<T>::list).name...});
+    }(std::make_index_sequence<field_count<T>> {});
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef DOCUMENT_CACHE_HPP
+#define DOCUMENT_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "data/Value.hpp"
+
+namespace toyjson::frontend {
+    struct DocumentCacheOptions {
+        size_t byte_budget = 256 * 1024 * 1024; // cached trees past this are evicted, least recently used first
+        bool verify_contents = false;            // also hash the file on every hit, catching rewrites that keep size and mtime
+    };
+
+    struct DocumentCacheStats {
+        size_t hits;
+        size_t misses;
+        size_t coalesced; // lookups that waited on another caller's parse of the same file
+        size_t evictions;
+        size_t entries;
+        size_t bytes;     // arena bytes held by cached trees
+    };
+
+    /**
+     * @brief Thread-safe cache of parsed files, shared as immutable arena-backed trees. Entries are checked against the file's inode, size and mtime on every lookup.
+     * @note Hits take no mutex and never wait on a parse: they load a snapshot of the entry table. That load is not lock-free in libstdc++, whose atomic shared_ptr briefly spins on an internal lock, so hits still contend with each other and with table swaps. Misses copy the table, which suits caches of up to a few thousand files.
+     */
+    class DocumentCache {
+        public:
+            using DocPtr = std::shared_ptr<const data::ToyJsonDocument>;
+
+            explicit DocumentCache(DocumentCacheOptions x_options = {});
+
+            DocumentCache(const DocumentCache& other) = delete;
+            DocumentCache& operator=(const DocumentCache& other) = delete;
+
+            /**
+             * @brief Returns the cached tree of a file, parsing it first if it is missing or changed on disk. Concurrent misses on one path share a single parse.
+             * @note Documents stay valid for as long as callers hold them, even once evicted.
+             * @throws std::system_error if the file cannot be stat'ed or read, or std::runtime_error if it is malformed. Failed parses are not cached.
+             */
+            [[nodiscard]] DocPtr get(const std::string& file_path_str);
+
+            void invalidate(const std::string& file_path_str);
+            void clear();
+
+            [[nodiscard]] DocumentCacheStats getStats() const;
+
+        private:
+            struct Entry;
+            using EntryTable = std::unordered_map<std::string, std::shared_ptr<Entry>>;
+
+            std::atomic<std::shared_ptr<const EntryTable>> table; // copy-on-write; not lock-free, see the class note
+            mutable std::mutex writer_guard; // serializes every table swap, and guards bytes
+            DocumentCacheOptions options;
+            std::atomic<std::uint64_t> clock;
+            std::atomic<size_t> hits;
+            std::atomic<size_t> misses;
+            std::atomic<size_t> coalesced;
+            std::atomic<size_t> evictions;
+            size_t bytes;
+
+            [[nodiscard]] DocPtr parseEntry(const std::string& file_path_str, const std::shared_ptr<Entry>& entry, std::promise<DocPtr>& promise);
+            void admitEntry(const std::string& file_path_str, const std::shared_ptr<Entry>& entry);
+            void dropEntry(const std::string& file_path_str, const std::shared_ptr<Entry>& entry);
+            void evictOver(EntryTable& next);
+    };
+}
+
+#endif
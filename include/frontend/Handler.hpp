@@ -0,0 +1,185 @@
+#ifndef HANDLER_HPP
+#define HANDLER_HPP
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "data/Tape.hpp"
+#include "data/Value.hpp"
+#include "utils/Arena.hpp"
+#include "frontend/NumberParse.hpp"
+
+namespace toyjson::frontend {
+    /**
+     * @brief Receiver of parse events in document order. Every callback returns true to keep going or false to stop the parse early.
+     * @note Strings and keys arrive unescaped. Their views are only valid during the callback.
+     */
+    template <typename Handler>
+    concept JsonHandler = requires(Handler& handler, bool flag, const NumberLiteral& number, std::string_view text) {
+        { handler.onNull() } -> std::convertible_to<bool>;
+        { handler.onBool(flag) } -> std::convertible_to<bool>;
+        { handler.onNumber(number) } -> std::convertible_to<bool>;
+        { handler.onString(text) } -> std::convertible_to<bool>;
+        { handler.onKey(text) } -> std::convertible_to<bool>;
+        { handler.onStartObject() } -> std::convertible_to<bool>;
+        { handler.onEndObject() } -> std::convertible_to<bool>;
+        { handler.onStartArray() } -> std::convertible_to<bool>;
+        { handler.onEndArray() } -> std::convertible_to<bool>;
+    };
+
+    /**
+     * @brief Optional extension for handlers that want source spans instead of converted scalars. Parser uses these in place of onNumber, onString and onKey when present.
+     * @note Keys with escapes still go through onKey, already decoded.
+     */
+    template <typename Handler>
+    concept RawScalarHandler = JsonHandler<Handler> && requires(Handler& handler, size_t offset, size_t length, bool escaped) {
+        { handler.onRawNumber(offset, length) } -> std::convertible_to<bool>;
+        { handler.onRawString(offset, length, escaped) } -> std::convertible_to<bool>;
+        { handler.onRawKey(offset, length) } -> std::convertible_to<bool>;
+    };
+
+    /**
+     * @brief Handler that builds the shared_ptr tree, optionally inside an arena.
+     */
+    class DomHandler {
+        public:
+            DomHandler();
+
+            /// @note Arena nodes get a no-op deleter: their memory goes back with the arena, so a dropped tree never walks its children.
+            explicit DomHandler(std::shared_ptr<utils::Arena> x_arena);
+
+            /// @param x_policy Under DuplicateKeyPolicy::reject, onKey stops the parse at the repeated key. See hasDuplicateKey().
+            DomHandler(std::shared_ptr<utils::Arena> x_arena, data::DuplicateKeyPolicy x_policy);
+
+            /// @param x_keys Long-lived table to intern keys into, shared across parses. If null, the document gets its own table on first object.
+            DomHandler(std::shared_ptr<utils::Arena> x_arena, data::DuplicateKeyPolicy x_policy, std::shared_ptr<data::KeyTable> x_keys);
+
+            bool onNull();
+            bool onBool(bool flag);
+            bool onNumber(const NumberLiteral& number);
+            bool onString(std::string_view text);
+            bool onKey(std::string_view key);
+            bool onStartObject();
+            bool onEndObject();
+            bool onStartArray();
+            bool onEndArray();
+
+            [[nodiscard]] data::ToyJsonDocument toDocument(const std::string& name);
+
+            /// @brief Opens a container with no node of its own, to collect a bare body from Parser::parseBodyEvents.
+            void beginBody(bool is_object);
+
+            /// @brief Closes the body opened by beginBody and hands over what it collected.
+            [[nodiscard]] data::ItemList releaseItems();
+            [[nodiscard]] data::PropertyTable releaseMembers();
+
+            [[nodiscard]] bool hasDuplicateKey() const;
+
+        private:
+            /// @brief One open container. Only the field matching is_object is used.
+            struct Frame {
+                data::ItemList items;
+                data::PropertyTable members;
+                data::Key key;
+                bool is_object;
+            };
+
+            /// @brief Recently seen keys by hash, so repeated keys skip the table and its lock.
+            static constexpr size_t key_cache_size = 64;
+
+            std::pmr::vector<Frame> frames;
+            std::shared_ptr<data::IJsonValue> root;
+            std::shared_ptr<utils::Arena> arena;
+            std::shared_ptr<data::KeyTable> keys;
+            std::array<data::Key, key_cache_size> key_cache;
+            std::pmr::memory_resource* resource;
+            data::DuplicateKeyPolicy policy;
+            bool duplicate_key;
+
+            [[nodiscard]] std::shared_ptr<data::IJsonValue> makeNode(data::AnyField x_node);
+            [[nodiscard]] data::Key internKey(std::string_view key);
+            bool attach(std::shared_ptr<data::IJsonValue> x_node);
+            void openFrame(bool is_object);
+    };
+
+    /**
+     * @brief Handler that records events onto a tape.
+     */
+    class TapeHandler {
+        public:
+            TapeHandler();
+
+            bool onNull();
+            bool onBool(bool flag);
+            bool onNumber(const NumberLiteral& number);
+            bool onString(std::string_view text);
+            bool onKey(std::string_view key);
+            bool onStartObject();
+            bool onEndObject();
+            bool onStartArray();
+            bool onEndArray();
+
+            [[nodiscard]] data::ToyJsonDocument toDocument(const std::string& name);
+
+        private:
+            data::TapeBuilder builder;
+    };
+
+    /**
+     * @brief Tape handler that keeps numbers and strings as spans of the source, converting them only when read.
+     * @note Escaped keys are still copied into the pool, since key lookups compare raw bytes.
+     */
+    class LazyTapeHandler {
+        public:
+            LazyTapeHandler() = delete;
+
+            /// @param source_sv The exact text being parsed. Raw offsets are relative to it.
+            explicit LazyTapeHandler(std::string_view source_sv);
+
+            bool onNull();
+            bool onBool(bool flag);
+            bool onNumber(const NumberLiteral& number);
+            bool onString(std::string_view text);
+            bool onKey(std::string_view key);
+            bool onRawNumber(size_t offset, size_t length);
+            bool onRawString(size_t offset, size_t length, bool escaped);
+            bool onRawKey(size_t offset, size_t length);
+            bool onStartObject();
+            bool onEndObject();
+            bool onStartArray();
+            bool onEndArray();
+
+            /// @param source_owner Must own the source text. The document holds it for its own lifetime.
+            [[nodiscard]] data::ToyJsonDocument toDocument(const std::string& name, std::shared_ptr<const void> source_owner);
+
+        private:
+            data::TapeBuilder builder;
+            std::string_view source;
+    };
+
+    /**
+     * @brief Handler that accepts and drops everything, so a value is still checked against the grammar but nothing is converted or built. Used to pass over members a binding does not declare.
+     */
+    class SkipHandler {
+        public:
+            bool onNull() { return true; }
+            bool onBool(bool) { return true; }
+            bool onNumber(const NumberLiteral&) { return true; }
+            bool onString(std::string_view) { return true; }
+            bool onKey(std::string_view) { return true; }
+            bool onRawNumber(size_t, size_t) { return true; }
+            bool onRawString(size_t, size_t, bool) { return true; }
+            bool onRawKey(size_t, size_t) { return true; }
+            bool onStartObject() { return true; }
+            bool onEndObject() { return true; }
+            bool onStartArray() { return true; }
+            bool onEndArray() { return true; }
+    };
+}
+
+#endif
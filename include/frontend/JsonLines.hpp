@@ -0,0 +1,93 @@
+#ifndef JSON_LINES_HPP
+#define JSON_LINES_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "utils/Arena.hpp"
+#include "utils/ThreadPool.hpp"
+#include "data/Value.hpp"
+#include "frontend/Parser.hpp"
+
+namespace toyjson::frontend {
+    enum class DeliveryOrder {
+        ordered,  // records reach the sink one at a time, in input order
+        unordered // records reach the sink as soon as they are parsed, from any worker at once
+    };
+
+    struct JsonLinesOptions {
+        size_t worker_count = 0;        // 0 for one per hardware thread
+        size_t batch_bytes = 256 * 1024; // input handed to a worker at a time, rounded up to a line end
+        DeliveryOrder order = DeliveryOrder::ordered;
+        std::shared_ptr<data::KeyTable> key_table {}; // shared by every record if set, else each record interns its own keys
+    };
+
+    struct JsonLinesStats {
+        size_t records;
+        size_t bytes;
+        double seconds;
+    };
+
+    /**
+     * @brief Parses newline-delimited JSON (one document per line) on a work-stealing pool. Each worker keeps one Parser and one Arena for its whole life, so records cost no setup.
+     * @note Blank lines are skipped. Unknown tokens, or anything but whitespace after a record's value on its line, make that record malformed. Delivery stops at the first malformed record, and parse() then throws naming its line.
+     */
+    class JsonLinesParser {
+        public:
+            /**
+             * @brief Receives each record with its 0-based line number.
+             * @note The document lives in its worker's arena, which is reused after the batch unless the sink kept a copy of the document.
+             */
+            using RecordSink = std::function<void(size_t line_index, data::ToyJsonDocument& doc)>;
+
+            JsonLinesParser() = delete;
+            explicit JsonLinesParser(JsonLinesOptions x_options);
+
+            JsonLinesParser(const JsonLinesParser& other) = delete;
+            JsonLinesParser& operator=(const JsonLinesParser& other) = delete;
+
+            JsonLinesStats parse(std::string_view text, const RecordSink& sink);
+
+            /// @brief Maps a file (or reads it, for pipes and "-" as stdin) and parses it in place.
+            JsonLinesStats parseFile(const std::string& file_path_str, const RecordSink& sink, bool populate = false);
+
+            [[nodiscard]] size_t getWorkerCount() const;
+
+        private:
+            struct WorkerState {
+                Parser parser;
+                std::shared_ptr<utils::Arena> arena;
+                std::vector<data::ToyJsonDocument> pending;
+                std::vector<size_t> pending_lines;
+            };
+
+            struct Batch {
+                size_t begin;
+                size_t end;
+                size_t first_line;
+            };
+
+            JsonLinesOptions options;
+            utils::ThreadPool pool;
+            std::vector<WorkerState> workers;
+            std::mutex turn_lock;
+            std::condition_variable turn_changed;
+            std::string error_msg;
+            std::atomic<size_t> error_line; // earliest failed line, written under turn_lock
+            size_t next_turn;
+            std::atomic<size_t> record_count;
+            std::atomic<bool> failed;
+
+            void runBatch(size_t worker_id, std::string_view text, const Batch& batch, size_t batch_index, const RecordSink& sink);
+            void recordError(size_t line_index, std::string_view what);
+            void recycleArena(WorkerState& state);
+    };
+}
+
+#endif
@@ -2,8 +2,7 @@
 #define LEXER_HPP
 
 #include <string_view>
-#include <string>
-#include <map>
+#include "frontend/NumberParse.hpp"
 #include "frontend/Token.hpp"
 
 namespace toyjson::frontend {
@@ -15,23 +14,49 @@ namespace toyjson::frontend {
         return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_';
     }
 
+    [[nodiscard]] constexpr bool isNumberStart(char c) {
+        return (c >= '0' && c <= '9') || c == '-';
+    }
+
+    /// @note Accepts every character a number lexeme may hold. The exact grammar is checked by isJsonNumber afterwards.
     [[nodiscard]] constexpr bool isNumeric(char c) {
-        return (c >= '0' && c <= '9') || c == '.';
+        return (c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-';
+    }
+
+    /// @brief Maps a word lexeme to its literal token type, or TokenType::unknown for anything else. Dispatches on length and first letter, so at most one literal is compared and nothing is allocated.
+    [[nodiscard]] constexpr TokenType lookupKeyword(std::string_view lexeme) {
+        using std::operator""sv;
+
+        switch (lexeme.length()) {
+            case 4:
+                if (lexeme[0] == 'n')
+                    return (lexeme == "null"sv) ? TokenType::lt_null : TokenType::unknown;
+
+                return (lexeme == "true"sv) ? TokenType::lt_true : TokenType::unknown;
+            case 5:
+                return (lexeme == "false"sv) ? TokenType::lt_false : TokenType::unknown;
+            default:
+                return TokenType::unknown;
+        }
     }
 
+    static_assert(lookupKeyword("null") == TokenType::lt_null && lookupKeyword("true") == TokenType::lt_true && lookupKeyword("false") == TokenType::lt_false);
+    static_assert(lookupKeyword("nul") == TokenType::unknown && lookupKeyword("tru_") == TokenType::unknown && lookupKeyword("falsy") == TokenType::unknown);
+
     class Lexer {
         public:
             Lexer() = delete;
             Lexer(std::string_view sv_arg);
 
+            /// @brief Restarts lexing over new input.
+            void reset(std::string_view sv_arg);
+
             [[nodiscard]] Token lexNext();
 
         private:
-            std::map<std::string, TokenType> kword_map;
             std::string_view symbols;
             size_t limit;
             size_t pos;
-            int line;
 
             [[nodiscard]] bool isAtEnd() const;
             [[nodiscard]] char peekSymbol() const;
@@ -0,0 +1,73 @@
+#ifndef NUMBER_PARSE_HPP
+#define NUMBER_PARSE_HPP
+
+#include <cstdint>
+#include <string_view>
+#include "data/IValue.hpp"
+
+namespace toyjson::frontend {
+    [[nodiscard]] constexpr bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    /// @brief Checks a lexeme against the JSON number grammar: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+    [[nodiscard]] constexpr bool isJsonNumber(std::string_view lexeme) {
+        size_t pos = 0;
+        size_t limit = lexeme.length();
+
+        if (pos < limit && lexeme[pos] == '-')
+            pos++;
+
+        if (pos >= limit || !isDigit(lexeme[pos]))
+            return false;
+
+        if (lexeme[pos] == '0') {
+            pos++;
+        } else {
+            while (pos < limit && isDigit(lexeme[pos]))
+                pos++;
+        }
+
+        if (pos < limit && lexeme[pos] == '.') {
+            pos++;
+
+            if (pos >= limit || !isDigit(lexeme[pos]))
+                return false;
+
+            while (pos < limit && isDigit(lexeme[pos]))
+                pos++;
+        }
+
+        if (pos < limit && (lexeme[pos] == 'e' || lexeme[pos] == 'E')) {
+            pos++;
+
+            if (pos < limit && (lexeme[pos] == '+' || lexeme[pos] == '-'))
+                pos++;
+
+            if (pos >= limit || !isDigit(lexeme[pos]))
+                return false;
+
+            while (pos < limit && isDigit(lexeme[pos]))
+                pos++;
+        }
+
+        return pos == limit;
+    }
+
+    /// @brief Converted number literal. Only the member matching kind is meaningful.
+    struct NumberLiteral {
+        data::NumberKind kind;
+        std::int64_t signed_whole;
+        std::uint64_t unsigned_whole;
+        double real;
+    };
+
+    /**
+     * @brief Converts a JSON number lexeme without allocating or consulting the locale. Integral literals that fit stay exact as int64/uint64, and everything else goes through std::from_chars, which rounds correctly. -0 becomes the double -0.0 so its sign survives.
+     * @note Values too large for a double saturate to +-infinity and values too small saturate to +-0, so every lexeme validate() accepts converts.
+     * @return false only if the lexeme is not a valid JSON number.
+     */
+    [[nodiscard]] bool parseNumber(std::string_view lexeme, NumberLiteral& result);
+}
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef ON_DEMAND_HPP
+#define ON_DEMAND_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "data/IValue.hpp"
+
+namespace toyjson::frontend {
+    class OnDemandItemIterator;
+    class OnDemandPropertyIterator;
+
+    /**
+     * @brief Handle to one value inside raw JSON text. Nothing is parsed until it is read, and siblings passed over on the way are skipped by bracket and quote matching without being built.
+     * @note Only the bytes actually walked are checked, so malformed text elsewhere goes unnoticed. Cheap to copy, and only valid while the text lives.
+     */
+    class OnDemandValue {
+        public:
+            OnDemandValue() = delete;
+            OnDemandValue(std::string_view x_source, size_t x_begin);
+
+            [[nodiscard]] data::JsonType getType() const;
+
+            [[nodiscard]] bool asBoolean() const;
+            [[nodiscard]] double asNumber() const;
+            [[nodiscard]] data::NumberKind getNumberKind() const;
+            [[nodiscard]] std::int64_t asInt64() const;
+            [[nodiscard]] std::uint64_t asUInt64() const;
+
+            /// @brief Returns the unescaped string, copying it.
+            [[nodiscard]] std::string asString() const;
+
+            /// @brief Returns the string body between its quotes with escapes left as-is. No copy.
+            [[nodiscard]] std::string_view asRawString() const;
+
+            /// @brief Returns this whole value's source text.
+            [[nodiscard]] std::string_view getRawJson() const;
+
+            [[nodiscard]] bool isEmpty() const;
+
+            /// @note Counting walks every element, so prefer iterating when the elements are needed anyway.
+            [[nodiscard]] size_t getLength() const;
+            [[nodiscard]] size_t getPropertyCount() const;
+
+            [[nodiscard]] OnDemandValue getItemPtr(size_t pos) const;
+
+            [[nodiscard]] bool hasProperty(std::string_view key) const;
+
+            /**
+             * @brief Finds a member by key, stopping at the first match so later members are never walked.
+             * @warning A repeated key yields its first value, unlike trees and tapes, which yield the last. Use DuplicateKeyPolicy::keep_first on the eager parse for identical results, or iterate the properties to see every repeat.
+             */
+            [[nodiscard]] OnDemandValue getValuePtr(std::string_view key) const;
+
+            [[nodiscard]] OnDemandItemIterator begin() const;
+            [[nodiscard]] OnDemandItemIterator end() const;
+
+            [[nodiscard]] OnDemandPropertyIterator beginProperties() const;
+            [[nodiscard]] OnDemandPropertyIterator endProperties() const;
+
+        private:
+            std::string_view source;
+            size_t begin_pos;
+
+            void expectType(data::JsonType type, const char* msg) const;
+            void loadNumber(data::NumberKind& kind, std::uint64_t& bits) const;
+
+            /// @note Returns the position of the matching value, or npos.
+            [[nodiscard]] size_t findProperty(std::string_view key) const;
+
+            friend class OnDemandItemIterator;
+            friend class OnDemandPropertyIterator;
+    };
+
+    /// @brief One object member seen during iteration.
+    struct OnDemandMember {
+        std::string_view raw_key;
+        OnDemandValue value;
+
+        [[nodiscard]] std::string getKey() const;
+    };
+
+    /**
+     * @brief Forward iterator over array elements. Each step skips the previous element in the raw text.
+     */
+    class OnDemandItemIterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = OnDemandValue;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = OnDemandValue;
+
+            OnDemandItemIterator();
+            OnDemandItemIterator(std::string_view x_source, size_t x_pos);
+
+            [[nodiscard]] OnDemandValue operator*() const;
+            OnDemandItemIterator& operator++();
+            OnDemandItemIterator operator++(int);
+
+            [[nodiscard]] bool operator==(const OnDemandItemIterator& other) const;
+
+        private:
+            std::string_view source;
+            size_t pos;
+    };
+
+    /**
+     * @brief Forward iterator over object members in source order. Each step skips the previous member's value in the raw text.
+     */
+    class OnDemandPropertyIterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = OnDemandMember;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = OnDemandMember;
+
+            OnDemandPropertyIterator();
+            OnDemandPropertyIterator(std::string_view x_source, size_t x_pos);
+
+            [[nodiscard]] OnDemandMember operator*() const;
+            OnDemandPropertyIterator& operator++();
+            OnDemandPropertyIterator operator++(int);
+
+            [[nodiscard]] bool operator==(const OnDemandPropertyIterator& other) const;
+
+        private:
+            std::string_view source;
+            size_t pos;
+    };
+
+    /**
+     * @brief Document that parses nothing up front. Navigation reads the raw text directly.
+     */
+    class OnDemandDocument {
+        public:
+            OnDemandDocument() = delete;
+
+            /// @note Does not own the text, which must outlive the document and its values.
+            OnDemandDocument(const std::string& name_str, std::string_view x_source);
+
+            /// @param x_source_ptr Owns the text. Held for the document's lifetime.
+            OnDemandDocument(const std::string& name_str, std::string_view x_source, std::shared_ptr<const void> x_source_ptr);
+
+            /// @brief Maps a file (or reads it, for pipes and "-" as stdin). The mapping lives exactly as long as the document.
+            [[nodiscard]] static OnDemandDocument openFile(const std::string& file_path_str, bool populate = false);
+
+            [[nodiscard]] const std::string& getTitle() const;
+            [[nodiscard]] OnDemandValue getRoot() const;
+
+        private:
+            std::string title;
+            std::shared_ptr<const void> source_ptr;
+            std::string_view source;
+    };
+}
+
+#endif
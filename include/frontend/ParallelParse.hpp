@@ -0,0 +1,59 @@
+#ifndef PARALLEL_PARSE_HPP
+#define PARALLEL_PARSE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "utils/ThreadPool.hpp"
+#include "data/Value.hpp"
+
+namespace toyjson::frontend {
+    struct ParallelOptions {
+        size_t worker_count = 0;                      // 0 for one per hardware thread
+        size_t min_parallel_bytes = 8 * 1024 * 1024;  // smaller inputs take the sequential path
+        size_t chunks_per_worker = 4;                 // extra chunks let stealing even out uneven elements
+        data::DuplicateKeyPolicy duplicate_keys = data::DuplicateKeyPolicy::keep_last;
+        std::shared_ptr<data::KeyTable> key_table {}; // if null, each parse makes one table for all its chunks
+    };
+
+    /**
+     * @brief Parses one large top-level array or object by slicing its body between top-level commas and parsing the slices concurrently. Elements are stitched back in order.
+     * @note The result matches Parser::parseToADT under the same DuplicateKeyPolicy exactly. Any other root, an input below the threshold, or a malformed slice goes through the sequential parser, so errors read the same too.
+     */
+    class ParallelParser {
+        public:
+            ParallelParser() = delete;
+            explicit ParallelParser(ParallelOptions x_options);
+
+            ParallelParser(const ParallelParser& other) = delete;
+            ParallelParser& operator=(const ParallelParser& other) = delete;
+
+            [[nodiscard]] data::ToyJsonDocument parse(const std::string& name, std::string_view json_sv);
+
+            [[nodiscard]] size_t getWorkerCount() const;
+
+        private:
+            struct Chunk {
+                size_t begin;
+                size_t end;
+                data::ItemList items;
+                data::PropertyTable members;
+                bool failed;
+            };
+
+            ParallelOptions options;
+            utils::ThreadPool pool;
+
+            [[nodiscard]] data::ToyJsonDocument parseSequential(const std::string& name, std::string_view json_sv, std::shared_ptr<data::KeyTable> keys) const;
+
+            /**
+             * @brief Pre-scans the root container for top-level commas at least target_bytes apart, using the SIMD structural index so quotes and escapes are tracked exactly.
+             * @return false if the root never closes. root_end then is unset.
+             */
+            [[nodiscard]] static bool findSplits(std::string_view json_sv, size_t root_pos, size_t target_bytes, std::vector<size_t>& splits, size_t& root_end);
+    };
+}
+
+#endif
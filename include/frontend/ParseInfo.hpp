@@ -1,6 +1,7 @@
 #ifndef PARSE_INFO
 #define PARSE_INFO
 
+#include <cstddef>
 #include <string_view>
 
 namespace toyjson::frontend {
@@ -8,6 +9,20 @@ namespace toyjson::frontend {
         err_none,
         err_unknown_token,
         err_misplaced_token,
+        err_bad_escape,
+        err_bad_number,
+        err_unexpected_eof,
+        err_duplicate_key,
+        err_type_mismatch,
+        err_unterminated_string,
+        err_expected_value,
+        err_expected_key,
+        err_expected_colon,
+        err_expected_separator, // neither ',' nor the container's closer after an entry
+        err_control_char,       // raw byte below 0x20 inside a string
+        err_invalid_utf8,
+        err_trailing_content,   // more than whitespace after the root value
+        err_too_deep,
         err_general
     };
 
@@ -18,11 +33,69 @@ namespace toyjson::frontend {
             return "Unknown token error"sv;
         else if (status == ParseStatus::err_misplaced_token)
             return "Misplaced token error"sv;
+        else if (status == ParseStatus::err_bad_escape)
+            return "Bad escape error"sv;
+        else if (status == ParseStatus::err_bad_number)
+            return "Bad number error"sv;
+        else if (status == ParseStatus::err_unexpected_eof)
+            return "Unexpected end of input error"sv;
+        else if (status == ParseStatus::err_duplicate_key)
+            return "Duplicate key error"sv;
+        else if (status == ParseStatus::err_type_mismatch)
+            return "Type mismatch error"sv;
+        else if (status == ParseStatus::err_unterminated_string)
+            return "Unterminated string error"sv;
+        else if (status == ParseStatus::err_expected_value)
+            return "Expected value error"sv;
+        else if (status == ParseStatus::err_expected_key)
+            return "Expected key error"sv;
+        else if (status == ParseStatus::err_expected_colon)
+            return "Expected colon error"sv;
+        else if (status == ParseStatus::err_expected_separator)
+            return "Expected separator error"sv;
+        else if (status == ParseStatus::err_control_char)
+            return "Control character error"sv;
+        else if (status == ParseStatus::err_invalid_utf8)
+            return "Invalid UTF-8 error"sv;
+        else if (status == ParseStatus::err_trailing_content)
+            return "Trailing content error"sv;
+        else if (status == ParseStatus::err_too_deep)
+            return "Nesting depth error"sv;
         else if (status == ParseStatus::err_general)
             return "General error"sv;
 
         return "OK"sv;
     }
+
+    /// @brief The first error of a parse. Holds no allocations, so reporting it costs nothing until it is printed.
+    struct ParseError {
+        ParseStatus status;
+        size_t offset;            // byte offset of the offending token in the input
+        std::string_view message; // static text
+    };
+
+    /// @brief 1-based line, and 1-based column counted in bytes.
+    struct SourcePosition {
+        size_t line;
+        size_t column;
+    };
+
+    /// @brief Finds the line and column of a byte offset by scanning the text before it, so only reported errors pay for it.
+    [[nodiscard]] constexpr SourcePosition locateOffset(std::string_view source, size_t offset) {
+        SourcePosition position {.line = 1, .column = 1};
+        size_t limit = (offset < source.length()) ? offset : source.length();
+
+        for (size_t pos = 0; pos < limit; pos++) {
+            if (source[pos] == '\n') {
+                position.line++;
+                position.column = 1;
+            } else {
+                position.column++;
+            }
+        }
+
+        return position;
+    }
 }
 
 #endif
\ No newline at end of file
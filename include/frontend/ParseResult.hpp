@@ -0,0 +1,90 @@
+#ifndef PARSE_RESULT_HPP
+#define PARSE_RESULT_HPP
+
+#include <utility>
+#include <variant>
+#include "frontend/ParseInfo.hpp"
+
+namespace toyjson::frontend {
+    /**
+     * @brief Either a parsed value or the ParseError that stopped the parse, in the manner of std::expected.
+     * @note operator* and operator-> are unchecked like std::expected's. getValue() throws std::bad_variant_access on an error.
+     */
+    template <typename T>
+    class ParseResult {
+        public:
+            ParseResult(T x_value)
+                : storage {std::in_place_index<0>, std::move(x_value)} {}
+
+            ParseResult(ParseError x_error)
+                : storage {std::in_place_index<1>, x_error} {}
+
+            [[nodiscard]] bool hasValue() const noexcept {
+                return storage.index() == 0;
+            }
+
+            [[nodiscard]] explicit operator bool() const noexcept {
+                return hasValue();
+            }
+
+            [[nodiscard]] T& operator*() noexcept {
+                return *std::get_if<0>(&storage);
+            }
+
+            [[nodiscard]] const T& operator*() const noexcept {
+                return *std::get_if<0>(&storage);
+            }
+
+            [[nodiscard]] T* operator->() noexcept {
+                return std::get_if<0>(&storage);
+            }
+
+            [[nodiscard]] const T* operator->() const noexcept {
+                return std::get_if<0>(&storage);
+            }
+
+            [[nodiscard]] T& getValue() {
+                return std::get<0>(storage);
+            }
+
+            [[nodiscard]] const T& getValue() const {
+                return std::get<0>(storage);
+            }
+
+            /// @note Only meaningful when !hasValue().
+            [[nodiscard]] const ParseError& getError() const noexcept {
+                return *std::get_if<1>(&storage);
+            }
+
+        private:
+            std::variant<T, ParseError> storage;
+    };
+
+    /// @brief Result of a parse that produces nothing but success, such as binding into a caller's target.
+    template <>
+    class ParseResult<void> {
+        public:
+            ParseResult() noexcept
+                : error {.status = ParseStatus::err_none, .offset = 0, .message = {}} {}
+
+            ParseResult(ParseError x_error) noexcept
+                : error {x_error} {}
+
+            [[nodiscard]] bool hasValue() const noexcept {
+                return error.status == ParseStatus::err_none;
+            }
+
+            [[nodiscard]] explicit operator bool() const noexcept {
+                return hasValue();
+            }
+
+            [[nodiscard]] const ParseError& getError() const noexcept {
+                return error;
+            }
+
+        private:
+            ParseError error;
+    };
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef PARSE_STATS_HPP
+#define PARSE_STATS_HPP
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iosfwd>
+#include "data/IValue.hpp"
+#include "frontend/Token.hpp"
+
+namespace toyjson::frontend {
+    inline constexpr size_t token_type_count = static_cast<size_t>(TokenType::eof) + 1;
+    inline constexpr size_t json_type_count = static_cast<size_t>(data::JsonType::j_any) + 1;
+
+    /**
+     * @brief Counters and timers for one parse. Only filled in builds configured with USE_STATS; see utils::stats_enabled. Elsewhere every field stays zero.
+     * @note Timers nest inside total_time, so total_time minus the others is roughly the time spent building the result.
+     */
+    struct ParseStats {
+        size_t bytes_lexed;
+        std::array<size_t, token_type_count> tokens; // by TokenType, whitespace and eof included
+        std::array<size_t, json_type_count> values;  // by JsonType, as emitted by the grammar
+        size_t max_depth;
+        size_t logged_errors;                        // unknown tokens reported to stderr
+        size_t allocs;                               // calling thread's operator new calls during the parse
+        size_t alloc_bytes;
+        std::chrono::nanoseconds lex_time;           // inside the lexer
+        std::chrono::nanoseconds number_time;        // converting number lexemes
+        std::chrono::nanoseconds string_time;        // unescaping strings and keys
+        std::chrono::nanoseconds total_time;
+    };
+
+    /// @brief Writes stats as "name: value" lines, one counter per line.
+    void printStats(std::ostream& out, const ParseStats& stats);
+}
+
+#endif
@@ -4,42 +4,719 @@
 #include <string_view>
 #include <initializer_list>
 #include <memory>
+#include <memory_resource>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include "utils/Arena.hpp"
+#include "utils/InputSource.hpp"
+#include "utils/Stats.hpp"
 #include "frontend/Token.hpp"
 #include "frontend/Lexer.hpp"
+#include "frontend/StructuralIndex.hpp"
+#include "frontend/NumberParse.hpp"
+#include "frontend/StringScan.hpp"
+#include "frontend/Handler.hpp"
+#include "frontend/Binding.hpp"
 #include "data/Value.hpp"
 #include "frontend/ParseInfo.hpp"
+#include "frontend/ParseResult.hpp"
+#include "frontend/ParseStats.hpp"
+#include "frontend/Validate.hpp"
 
 namespace toyjson::frontend {
     using JsonValue = data::IJsonValue;
     using JsonDoc = data::ToyJsonDocument;
 
+    enum class LexMode {
+        sequential, // byte-at-a-time Lexer
+        indexed     // SIMD stage-1 StructuralIndex, used for inputs up to 4 GiB
+    };
+
+    /// @brief A tree document with the stats of the parse that built it.
+    struct StatsDoc {
+        JsonDoc doc;
+        ParseStats stats;
+    };
+
     class Parser {
         public:
             Parser(std::string_view json_sv);
+            Parser(std::string_view json_sv, LexMode mode);
+
+            /// @brief Rebinds this parser onto new input with the same LexMode, so one parser can serve many documents. Scratch buffers and the structural index keep their capacity, so once warm, small documents lex without allocating.
+            void reset(std::string_view json_sv);
+
+            /// @brief Like reset(json_sv), but also switches the LexMode. The lexer is only rebuilt when its kind changes.
+            void reset(std::string_view json_sv, LexMode mode);
+
+            /// @brief Sets how tree parses treat repeated object keys. Defaults to DuplicateKeyPolicy::keep_last. Tapes ignore it and always look up the last value of a repeated key.
+            void setDuplicateKeyPolicy(data::DuplicateKeyPolicy policy);
+
+            /// @brief Interns tree keys into a long-lived table shared across parses, instead of one table per document. Pass nullptr to go back to per-document tables.
+            void setKeyTable(std::shared_ptr<data::KeyTable> keys);
+
+            /**
+             * @brief Streams one JSON value to the handler without building any document. Calls are resolved at compile time, so they inline.
+             * @return true if the whole value was parsed, false if the handler stopped early.
+             * @throws std::runtime_error on malformed input, as the document parses do.
+             */
+            template <JsonHandler Handler>
+            bool parseEvents(Handler& handler);
+
+            /**
+             * @brief Streams the elements (or members, when is_object is set) of a container body whose brackets lie outside this parser's input. Used to parse slices of one container in parallel.
+             * @note The body must hold at least one entry and nothing after its last one.
+             */
+            template <JsonHandler Handler>
+            bool parseBodyEvents(Handler& handler, bool is_object);
+
+            /**
+             * @brief Parses one value straight into a typed target, with no tree in between. See frontend/Binding.hpp for the supported types.
+             * @note Bound struct members missing from the input keep their current values, and members the struct does not declare are skipped.
+             * @throws std::runtime_error on malformed input, or on a value whose JSON type or range does not fit its target.
+             */
+            template <typename T>
+            void parseInto(T& target);
 
             [[nodiscard]] JsonDoc parseToADT(const std::string& name);
 
+            /// @brief Parses into a tree like parseToADT, also returning its stats. They are all zero unless built with USE_STATS.
+            [[nodiscard]] StatsDoc parseWithStats(const std::string& name);
+
+            /**
+             * @brief Parses into a tree whose nodes, strings and containers all live in the given arena. The document keeps the arena alive, and dropping it skips the per-node teardown entirely.
+             * @note Callers may keep their own reference to the arena and reset() it once the document is gone to reuse its blocks.
+             * @warning Node pointers copied out of the document dangle once the document and arena are gone.
+             */
+            [[nodiscard]] JsonDoc parseToADT(const std::string& name, std::shared_ptr<utils::Arena> arena);
+
+            /// @brief Parses into one contiguous tape instead of a shared_ptr tree. See data::JsonTape.
+            [[nodiscard]] JsonDoc parseToTape(const std::string& name);
+
+            /**
+             * @brief Parses into a tape whose strings and numbers stay as spans of the input and are only converted when read.
+             * @param source_owner Must own the text this Parser was given. The document holds it for its own lifetime.
+             */
+            [[nodiscard]] JsonDoc parseToLazyTape(const std::string& name, std::shared_ptr<const void> source_owner);
+
+            /**
+             * @brief Maps a file (or reads it, for pipes and "-" as stdin) and lazily parses it in place. The mapping lives exactly as long as the returned document.
+             * @param populate Prefault the whole mapping before parsing.
+             */
+            [[nodiscard]] static JsonDoc parseMappedFile(const std::string& file_path_str, bool populate = false);
+
+            /// @brief Stats of the latest parse of any kind on this parser. See ParseStats.
+            [[nodiscard]] const ParseStats& getStats() const;
+
+            /*
+             * Non-throwing parses: the first error, unknown tokens included, stops the parse and comes back as a ParseError.
+             * Nothing is logged and no exception or message string is built, so malformed input costs no more than valid input.
+             * The throwing parses above skip unknown tokens with a note on stderr instead, as they always have.
+             * Every parse fails with err_too_deep past max_validate_depth nested containers.
+             */
+
+            /// @return Whether the whole value was parsed, or false if the handler stopped early.
+            template <JsonHandler Handler>
+            [[nodiscard]] ParseResult<bool> tryParseEvents(Handler& handler);
+
+            template <typename T>
+            [[nodiscard]] ParseResult<void> tryParseInto(T& target);
+
+            [[nodiscard]] ParseResult<JsonDoc> tryParseToADT(const std::string& name);
+            [[nodiscard]] ParseResult<JsonDoc> tryParseToADT(const std::string& name, std::shared_ptr<utils::Arena> arena);
+            [[nodiscard]] ParseResult<JsonDoc> tryParseToTape(const std::string& name);
+
+            /// @brief Whether anything but whitespace follows the value of the latest successful parse. Every parse stops after one value and leaves the rest unread.
+            [[nodiscard]] bool hasTrailingInput() const;
+
+            /// @brief Line and column of an error from this parser's current input.
+            [[nodiscard]] SourcePosition locateError(const ParseError& error) const;
+
         private:
-            Lexer lexer;
+            /// @brief Restarts the stats for one parse, then adds its total time and allocations when it ends.
+            class StatsScope {
+                public:
+                    explicit StatsScope(Parser& x_parser);
+                    ~StatsScope();
+
+                    StatsScope(const StatsScope& other) = delete;
+                    StatsScope& operator=(const StatsScope& other) = delete;
+
+                private:
+                    Parser& parser;
+                    utils::AllocTally allocs_before;
+                    utils::StatTimer total_timer;
+            };
+
+            std::variant<Lexer, IndexedLexer> lexer;
             Token current;
             Token previous;
             std::string_view symbols;
+            std::string scratch;
+            LexMode lex_mode;
+            data::DuplicateKeyPolicy key_policy;
+            std::shared_ptr<data::KeyTable> key_table;
+            ParseStats stats;
+            size_t depth;
+            ParseError error;
+            bool strict_tokens; // unknown tokens stop the parse instead of being logged and skipped
+
+            [[nodiscard]] static std::variant<Lexer, IndexedLexer> createLexer(std::string_view json_sv, LexMode mode);
+
+            [[nodiscard]] static std::string createErrorMsg(const ParseError& culprit_error);
+            void logErrorBy(const Token& culprit, ParseStatus status, std::string_view msg_sv);
 
-            [[nodiscard ]] std::string createErrorMsg(const Token& culprit, ParseStatus status, std::string_view msg_sv);
-            void logErrorBy(const Token& culprit, ParseStatus status, std::string_view msg_sv) const;
+            /// @brief Records the first error of a parse, refining its kind when the culprit is the end of input or an unknown token. Always returns false, so the grammar can unwind by returning it.
+            bool fail(const Token& culprit, ParseStatus status, std::string_view msg_sv);
+
+            /// @brief Clears the last error and picks how unknown tokens are treated, before a parse starts.
+            void beginParse(bool strict);
+
+            /// @throws std::runtime_error if the latest parse recorded an error.
+            void throwOnError() const;
 
             const Token& peekCurrent() const;
             const Token& peekPrevious() const;
             [[nodiscard]] bool isAtEOF() const;
+            [[nodiscard]] Token lexNext();
             [[nodiscard]] Token doAdvance();
             [[nodiscard]] bool matchToken(const Token& token, std::initializer_list<TokenType> types);
-            void consumeToken(std::initializer_list<TokenType> types);
+            bool consumeToken(std::initializer_list<TokenType> types);
+
+            /// @brief Passes the current token if it has the given type, else fails with the given status.
+            [[nodiscard]] bool expectToken(TokenType type, ParseStatus status, std::string_view msg_sv);
+
+            /// @note Returns an empty document after an error.
+            [[nodiscard]] JsonDoc buildTree(const std::string& name, std::shared_ptr<utils::Arena> arena, bool strict);
+
+            /// @note The run functions are the error-recording cores of the parse and tryParse functions.
+            template <JsonHandler Handler>
+            [[nodiscard]] bool runEvents(Handler& handler, bool strict);
+
+            template <JsonHandler Handler>
+            [[nodiscard]] bool runBodyEvents(Handler& handler, bool is_object, bool strict);
+
+            template <typename T>
+            [[nodiscard]] bool runInto(T& target, bool strict);
+
+            [[nodiscard]] bool convertNumber(const Token& token, NumberLiteral& literal);
+            [[nodiscard]] bool decodeToScratch(const Token& token, std::string_view& text);
+
+            /// @brief Checks every escape of a string token without decoding it, for handlers that keep raw spans.
+            [[nodiscard]] bool checkEscapes(const Token& token, bool& escaped);
+
+            void countValue(data::JsonType type);
+
+            /// @brief Opens a container, failing with err_too_deep past max_validate_depth so that deep input cannot exhaust the stack.
+            [[nodiscard]] bool enterContainer(const Token& opener);
+            void leaveContainer();
+
+            template <JsonHandler Handler>
+            bool emitValue(Handler& handler);
+
+            template <JsonHandler Handler>
+            bool emitKey(Handler& handler);
+
+            template <JsonHandler Handler>
+            bool emitArray(Handler& handler);
+
+            template <JsonHandler Handler>
+            bool emitObject(Handler& handler);
 
-            std::shared_ptr<JsonValue> parseValue();
+            [[nodiscard]] bool skipValue();
 
-            std::shared_ptr<JsonValue> parseArray();
-            std::shared_ptr<JsonValue> parseObject();
+            /// @note Each bind function passes its whole value, brackets included, and returns false after recording an error.
+            template <typename T>
+            [[nodiscard]] bool bindValue(T& target);
+
+            template <typename T>
+            [[nodiscard]] bool bindNumber(T& target);
+
+            template <typename T>
+            [[nodiscard]] bool bindArray(T& target);
+
+            template <typename T>
+            [[nodiscard]] bool bindObject(T& target);
+
+            template <typename T>
+            [[nodiscard]] bool bindMap(T& target);
+
+            template <typename T, size_t... Ids>
+            [[nodiscard]] bool bindField(T& target, size_t field_pos, std::index_sequence<Ids...>);
+
+            /// @brief Checks and passes the key at the current token, and the ':' after it.
+            [[nodiscard]] bool bindKey(std::string_view& key);
+
+            /// @brief Passes the ',' after a container entry, setting at_closer instead at the closer, which is left for bindCloser.
+            [[nodiscard]] bool bindSeparator(TokenType closer, std::string_view msg_sv, bool& at_closer);
+
+            /// @brief Passes a container's closer, which input may not end before.
+            [[nodiscard]] bool bindCloser(TokenType closer);
     };
+
+    /* Instrumentation impl. */
+
+    inline Parser::StatsScope::StatsScope(Parser& x_parser)
+        : parser {x_parser}, allocs_before {}, total_timer {x_parser.stats.total_time} {
+        if constexpr (utils::stats_enabled) {
+            parser.stats = ParseStats {};
+            allocs_before = utils::readThreadAllocs();
+        }
+    }
+
+    inline Parser::StatsScope::~StatsScope() {
+        if constexpr (utils::stats_enabled) {
+            auto allocs_after = utils::readThreadAllocs();
+
+            parser.stats.allocs = allocs_after.allocs - allocs_before.allocs;
+            parser.stats.alloc_bytes = allocs_after.bytes - allocs_before.bytes;
+        }
+    }
+
+    inline void Parser::countValue(data::JsonType type) {
+        if constexpr (utils::stats_enabled)
+            stats.values[static_cast<size_t>(type)]++;
+    }
+
+    inline bool Parser::enterContainer(const Token& opener) {
+        if (depth == max_validate_depth)
+            return fail(opener, ParseStatus::err_too_deep, "Nesting too deep.");
+
+        depth++;
+
+        if constexpr (utils::stats_enabled)
+            stats.max_depth = std::max(stats.max_depth, depth);
+
+        return true;
+    }
+
+    inline void Parser::leaveContainer() {
+        depth--;
+    }
+
+    /* Event grammar impl. */
+
+    template <JsonHandler Handler>
+    bool Parser::parseEvents(Handler& handler) {
+        bool finished = runEvents(handler, false);
+
+        throwOnError();
+
+        return finished;
+    }
+
+    template <JsonHandler Handler>
+    bool Parser::parseBodyEvents(Handler& handler, bool is_object) {
+        bool finished = runBodyEvents(handler, is_object, false);
+
+        throwOnError();
+
+        return finished;
+    }
+
+    template <JsonHandler Handler>
+    ParseResult<bool> Parser::tryParseEvents(Handler& handler) {
+        bool finished = runEvents(handler, true);
+
+        if (error.status != ParseStatus::err_none)
+            return error;
+
+        return finished;
+    }
+
+    template <JsonHandler Handler>
+    bool Parser::runEvents(Handler& handler, bool strict) {
+        StatsScope stats_scope {*this};
+
+        beginParse(strict);
+        consumeToken({}); // pass initial unknowns
+
+        return emitValue(handler);
+    }
+
+    template <JsonHandler Handler>
+    bool Parser::runBodyEvents(Handler& handler, bool is_object, bool strict) {
+        StatsScope stats_scope {*this};
+
+        beginParse(strict);
+        consumeToken({}); // pass initial unknowns
+
+        while (true) {
+            if (is_object && !emitKey(handler))
+                return false;
+
+            if (!emitValue(handler))
+                return false;
+
+            if (isAtEOF())
+                return true;
+
+            if (!expectToken(TokenType::comma, ParseStatus::err_expected_separator, "Unexpected token between entries."))
+                return false;
+        }
+    }
+
+    template <JsonHandler Handler>
+    bool Parser::emitValue(Handler& handler) {
+        Token token = peekCurrent();
+
+        if (token.type == TokenType::lt_null) {
+            countValue(data::JsonType::j_null);
+            consumeToken({});
+            return handler.onNull();
+        } else if (token.type == TokenType::lt_true || token.type == TokenType::lt_false) {
+            countValue(data::JsonType::j_boolean);
+            consumeToken({});
+            return handler.onBool(token.type == TokenType::lt_true);
+        } else if (token.type == TokenType::lt_number) {
+            countValue(data::JsonType::j_number);
+
+            if constexpr (RawScalarHandler<Handler>) {
+                consumeToken({});
+                return handler.onRawNumber(token.begin, token.length);
+            } else {
+                NumberLiteral literal;
+
+                if (!convertNumber(token, literal))
+                    return false;
+
+                consumeToken({});
+                return handler.onNumber(literal);
+            }
+        } else if (token.type == TokenType::lt_strbody) {
+            countValue(data::JsonType::j_string);
+
+            if constexpr (RawScalarHandler<Handler>) {
+                bool escaped = false;
+
+                if (!checkEscapes(token, escaped))
+                    return false;
+
+                consumeToken({});
+                return handler.onRawString(token.begin, token.length, escaped);
+            } else {
+                std::string_view text;
+
+                if (!decodeToScratch(token, text))
+                    return false;
+
+                consumeToken({});
+                return handler.onString(text);
+            }
+        } else if (token.type == TokenType::lbrack) {
+            return emitArray(handler);
+        } else if (token.type == TokenType::lbrace) {
+            return emitObject(handler);
+        }
+
+        return fail(token, ParseStatus::err_expected_value, "Unexpected token for value.");
+    }
+
+    /// @note Also passes the ':' after the key.
+    template <JsonHandler Handler>
+    bool Parser::emitKey(Handler& handler) {
+        Token key_token = peekCurrent();
+        bool keep_going = true;
+
+        if (key_token.type != TokenType::lt_strbody)
+            return fail(key_token, ParseStatus::err_expected_key, "Expected a property name.");
+
+        if constexpr (RawScalarHandler<Handler>) {
+            if (findBackslash(viewLexeme(key_token, symbols), 0) == std::string_view::npos) {
+                keep_going = handler.onRawKey(key_token.begin, key_token.length);
+            } else {
+                std::string_view key;
+
+                if (!decodeToScratch(key_token, key))
+                    return false;
+
+                keep_going = handler.onKey(key);
+            }
+        } else {
+            std::string_view key;
+
+            if (!decodeToScratch(key_token, key))
+                return false;
+
+            keep_going = handler.onKey(key);
+        }
+
+        if (!keep_going)
+            return false;
+
+        consumeToken({});
+
+        return expectToken(TokenType::colon, ParseStatus::err_expected_colon, "Expected ':' after property name.");
+    }
+
+    /// @note Input ending before the ']' fails as err_unexpected_eof.
+    template <JsonHandler Handler>
+    bool Parser::emitArray(Handler& handler) {
+        if (!enterContainer(peekCurrent()))
+            return false;
+
+        consumeToken({}); // pass '[' symbol
+        countValue(data::JsonType::j_array);
+
+        if (!handler.onStartArray())
+            return false;
+
+        while (!matchToken(peekCurrent(), {TokenType::rbrack})) {
+            if (!emitValue(handler))
+                return false;
+
+            if (matchToken(peekCurrent(), {TokenType::comma}))
+                consumeToken({});
+            else if (!matchToken(peekCurrent(), {TokenType::rbrack}))
+                return fail(peekCurrent(), ParseStatus::err_expected_separator, "Unexpected token in Array.");
+        }
+
+        consumeToken({}); // pass ']' symbol
+        leaveContainer();
+
+        return handler.onEndArray();
+    }
+
+    template <JsonHandler Handler>
+    bool Parser::emitObject(Handler& handler) {
+        if (!enterContainer(peekCurrent()))
+            return false;
+
+        consumeToken({}); // pass '{' symbol
+        countValue(data::JsonType::j_object);
+
+        if (!handler.onStartObject())
+            return false;
+
+        while (!matchToken(peekCurrent(), {TokenType::rbrace})) {
+            if (!emitKey(handler))
+                return false;
+
+            if (!emitValue(handler))
+                return false;
+
+            if (matchToken(peekCurrent(), {TokenType::comma}))
+                consumeToken({});
+            else if (!matchToken(peekCurrent(), {TokenType::rbrace}))
+                return fail(peekCurrent(), ParseStatus::err_expected_separator, "Unexpected token in Object.");
+        }
+
+        consumeToken({}); // pass '}' symbol
+        leaveContainer();
+
+        return handler.onEndObject();
+    }
+
+    /* Binding grammar impl. */
+
+    template <typename T>
+    void Parser::parseInto(T& target) {
+        (void)runInto(target, false);
+        throwOnError();
+    }
+
+    template <typename T>
+    ParseResult<void> Parser::tryParseInto(T& target) {
+        (void)runInto(target, true);
+
+        if (error.status != ParseStatus::err_none)
+            return error;
+
+        return {};
+    }
+
+    template <typename T>
+    bool Parser::runInto(T& target, bool strict) {
+        StatsScope stats_scope {*this};
+
+        beginParse(strict);
+        consumeToken({}); // pass initial unknowns
+
+        return bindValue(target);
+    }
+
+    template <typename T>
+    bool Parser::bindValue(T& target) {
+        const Token& token = peekCurrent();
+
+        if constexpr (IsOptional<T>::value) {
+            if (token.type == TokenType::lt_null) {
+                consumeToken({});
+                target.reset();
+                return true;
+            }
+
+            if (!target.has_value())
+                target.emplace();
+
+            return bindValue(*target);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            if (token.type != TokenType::lt_true && token.type != TokenType::lt_false)
+                return fail(token, ParseStatus::err_type_mismatch, "Expected a boolean.");
+
+            target = token.type == TokenType::lt_true;
+            consumeToken({});
+
+            return true;
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            return bindNumber(target);
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            std::string_view text;
+
+            if (token.type != TokenType::lt_strbody)
+                return fail(token, ParseStatus::err_type_mismatch, "Expected a string.");
+
+            if (!decodeToScratch(token, text))
+                return false;
+
+            target.assign(text);
+            consumeToken({});
+
+            return true;
+        } else if constexpr (IsVector<T>::value) {
+            return bindArray(target);
+        } else if constexpr (IsStringMap<T>::value) {
+            return bindMap(target);
+        } else if constexpr (BoundObject<T>) {
+            return bindObject(target);
+        } else {
+            static_assert(BoundObject<T>, "Type has no JSON binding. Specialize toyjson::frontend::JsonFields for it.");
+        }
+    }
+
+    template <typename T>
+    bool Parser::bindNumber(T& target) {
+        const Token& token = peekCurrent();
+        NumberLiteral literal;
+
+        if (token.type != TokenType::lt_number)
+            return fail(token, ParseStatus::err_type_mismatch, "Expected a number.");
+
+        if (!convertNumber(token, literal))
+            return false;
+
+        if constexpr (std::is_floating_point_v<T>) {
+            if (literal.kind == data::NumberKind::j_int64)
+                target = static_cast<T>(literal.signed_whole);
+            else if (literal.kind == data::NumberKind::j_uint64)
+                target = static_cast<T>(literal.unsigned_whole);
+            else
+                target = static_cast<T>(literal.real);
+        } else {
+            bool fits = (literal.kind == data::NumberKind::j_int64 && std::in_range<T>(literal.signed_whole))
+                || (literal.kind == data::NumberKind::j_uint64 && std::in_range<T>(literal.unsigned_whole));
+
+            if (!fits)
+                return fail(token, ParseStatus::err_type_mismatch, "Number does not fit its integer target.");
+
+            target = (literal.kind == data::NumberKind::j_int64) ? static_cast<T>(literal.signed_whole) : static_cast<T>(literal.unsigned_whole);
+        }
+
+        consumeToken({});
+
+        return true;
+    }
+
+    template <typename T>
+    bool Parser::bindArray(T& target) {
+        bool at_closer = false;
+
+        if (peekCurrent().type != TokenType::lbrack)
+            return fail(peekCurrent(), ParseStatus::err_type_mismatch, "Expected an array.");
+
+        consumeToken({}); // pass '[' symbol
+        target.clear();
+
+        while (!isAtEOF() && !at_closer) {
+            if (matchToken(peekCurrent(), {TokenType::rbrack}))
+                break;
+
+            typename T::value_type item {};
+
+            if (!bindValue(item))
+                return false;
+
+            target.push_back(std::move(item));
+
+            if (!bindSeparator(TokenType::rbrack, "Unexpected token in Array.", at_closer))
+                return false;
+        }
+
+        return bindCloser(TokenType::rbrack);
+    }
+
+    template <typename T>
+    bool Parser::bindObject(T& target) {
+        constexpr auto& index = field_index<T>;
+        bool at_closer = false;
+
+        if (peekCurrent().type != TokenType::lbrace)
+            return fail(peekCurrent(), ParseStatus::err_type_mismatch, "Expected an object.");
+
+        consumeToken({}); // pass '{' symbol
+
+        while (!isAtEOF() && !at_closer) {
+            std::string_view key;
+
+            if (matchToken(peekCurrent(), {TokenType::rbrace}))
+                break;
+
+            if (!bindKey(key))
+                return false;
+
+            size_t field_pos = index.find(key);
+            bool bound = (field_pos == index.npos)
+                ? skipValue()
+                : bindField(target, field_pos, std::make_index_sequence<field_count<T>> {});
+
+            if (!bound || !bindSeparator(TokenType::rbrace, "Unexpected token in Object.", at_closer))
+                return false;
+        }
+
+        return bindCloser(TokenType::rbrace);
+    }
+
+    template <typename T>
+    bool Parser::bindMap(T& target) {
+        bool at_closer = false;
+
+        if (peekCurrent().type != TokenType::lbrace)
+            return fail(peekCurrent(), ParseStatus::err_type_mismatch, "Expected an object.");
+
+        consumeToken({}); // pass '{' symbol
+        target.clear();
+
+        while (!isAtEOF() && !at_closer) {
+            std::string_view key;
+
+            if (matchToken(peekCurrent(), {TokenType::rbrace}))
+                break;
+
+            if (!bindKey(key))
+                return false;
+
+            if (!bindValue(target[std::string {key}]))
+                return false;
+
+            if (!bindSeparator(TokenType::rbrace, "Unexpected token in Object.", at_closer))
+                return false;
+        }
+
+        return bindCloser(TokenType::rbrace);
+    }
+
+    /// @note The fold compiles to a jump over field positions, so each field's bindValue is resolved statically.
+    template <typename T, size_t... Ids>
+    bool Parser::bindField(T& target, size_t field_pos, std::index_sequence<Ids...>) {
+        bool bound = true;
+
+        (void)((field_pos == Ids && (bound = bindValue(target.*(std::get<Ids>(JsonFields<T>::list).member)), true)) || ...);
+
+        return bound;
+    }
 }
 
 #endif
\ No newline at end of file
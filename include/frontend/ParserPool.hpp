@@ -0,0 +1,46 @@
+#ifndef PARSER_POOL_HPP
+#define PARSER_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include "frontend/Parser.hpp"
+
+namespace toyjson::frontend {
+    /// @brief Idle parsers each thread keeps warm. Leases ending beyond this just free their parser.
+    inline constexpr size_t max_pooled_parsers = 8;
+
+    /**
+     * @brief A parser borrowed from the calling thread's pool, handed back when the lease ends so its buffers stay warm for the next document.
+     * @note A lease ending on another thread returns its parser to that thread's pool instead.
+     */
+    class ParserLease {
+        public:
+            ParserLease() = delete;
+            explicit ParserLease(std::unique_ptr<Parser> x_parser);
+
+            ParserLease(const ParserLease& other) = delete;
+            ParserLease& operator=(const ParserLease& other) = delete;
+            ParserLease(ParserLease&& other) noexcept = default;
+            ParserLease& operator=(ParserLease&& other) = delete;
+
+            ~ParserLease();
+
+            [[nodiscard]] Parser& operator*() const;
+            [[nodiscard]] Parser* operator->() const;
+
+        private:
+            std::unique_ptr<Parser> parser;
+    };
+
+    /**
+     * @brief Borrows a warm parser from the calling thread's pool, or makes one if none is idle, and resets it onto the input.
+     * @note Leased parsers always start with the default duplicate key policy and no shared key table.
+     */
+    [[nodiscard]] ParserLease acquireParser(std::string_view json_sv, LexMode mode = LexMode::indexed);
+
+    /// @brief Frees the calling thread's idle parsers along with the buffer capacity they kept.
+    void trimParserPool();
+}
+
+#endif
@@ -0,0 +1,480 @@
+#ifndef PUSH_PARSER_HPP
+#define PUSH_PARSER_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "frontend/Handler.hpp"
+#include "frontend/Lexer.hpp"
+#include "frontend/NumberParse.hpp"
+#include "frontend/ParseInfo.hpp"
+#include "frontend/StringScan.hpp"
+#include "frontend/Token.hpp"
+
+namespace toyjson::frontend {
+    enum class PushStatus {
+        need_more, // feed() more input, or finish() if there is none
+        complete,  // one whole document was seen, only whitespace may follow
+        stopped,   // the handler asked to stop
+        failed     // see getError() and getErrorOffset()
+    };
+
+    /**
+     * @brief Resumable parser for input arriving in chunks. Tokens, strings and numbers may straddle chunk boundaries.
+     * @note Memory stays proportional to nesting depth plus the one token currently split across chunks. Complete tokens inside a chunk are handed to the handler without copying.
+     */
+    template <JsonHandler Handler>
+    class PushParser {
+        public:
+            PushParser() = delete;
+            explicit PushParser(Handler& x_handler)
+                : handler {&x_handler}, open_stack {}, pending {}, scratch {}, consumed {0}, error_offset {0}, pending_offset {0},
+                expect {Expect::value}, partial {Partial::none}, status {PushStatus::need_more}, error {ParseStatus::err_none},
+                pending_escape {false}, pending_has_escape {false} {}
+
+            PushStatus feed(std::string_view chunk);
+            PushStatus finish();
+
+            /// @brief Clears all state so the next feed() starts a new document. Buffers keep their capacity.
+            void reset();
+
+            [[nodiscard]] ParseStatus getError() const {
+                return error;
+            }
+
+            [[nodiscard]] size_t getErrorOffset() const {
+                return error_offset;
+            }
+
+            [[nodiscard]] size_t getDepth() const {
+                return open_stack.size();
+            }
+
+        private:
+            enum class Expect : std::uint8_t {
+                value,
+                value_or_end,
+                key,
+                key_or_end,
+                colon,
+                comma_or_end,
+                nothing
+            };
+
+            enum class Partial : std::uint8_t {
+                none,
+                string,
+                key,
+                literal
+            };
+
+            Handler* handler;
+            std::vector<TokenType> open_stack;
+            std::string pending;
+            std::string scratch;
+            size_t consumed;
+            size_t error_offset;
+            size_t pending_offset; // input offset where the token held in pending starts
+            Expect expect;
+            Partial partial;
+            PushStatus status;
+            ParseStatus error;
+            bool pending_escape;
+            bool pending_has_escape;
+
+            [[nodiscard]] static constexpr bool isLiteralSymbol(char c) {
+                return isNumeric(c) || isWordSymbol(c);
+            }
+
+            PushStatus fail(ParseStatus code, size_t chunk_pos);
+            PushStatus failAt(ParseStatus code, size_t offset);
+            PushStatus stop();
+
+            [[nodiscard]] size_t scanStringBody(std::string_view chunk, size_t pos);
+            /// @note offset is where the token starts in the whole input, not the chunk, since a split token may have begun several chunks back.
+            [[nodiscard]] bool emitString(std::string_view raw, bool is_key, bool has_escape, size_t offset);
+            [[nodiscard]] bool emitLiteral(std::string_view lexeme, size_t offset);
+            [[nodiscard]] bool closeContainer(TokenType closer, size_t chunk_pos);
+            void afterValue();
+
+            [[nodiscard]] bool resumePartial(std::string_view chunk, size_t& pos);
+            [[nodiscard]] bool stepToken(std::string_view chunk, size_t& pos);
+    };
+
+    /* PushParser impl. */
+
+    template <JsonHandler Handler>
+    PushStatus PushParser<Handler>::feed(std::string_view chunk) {
+        if (status != PushStatus::need_more && status != PushStatus::complete)
+            return status;
+
+        size_t pos = 0;
+
+        if (partial != Partial::none && !resumePartial(chunk, pos)) {
+            if (status == PushStatus::need_more || status == PushStatus::complete)
+                consumed += chunk.length();
+
+            return status;
+        }
+
+        while (pos < chunk.length()) {
+            if (isSpacing(chunk[pos])) {
+                pos++;
+                continue;
+            }
+
+            if (!stepToken(chunk, pos))
+                break;
+        }
+
+        if (status == PushStatus::need_more || status == PushStatus::complete) {
+            consumed += chunk.length();
+            status = (expect == Expect::nothing && partial == Partial::none) ? PushStatus::complete : PushStatus::need_more;
+        }
+
+        return status;
+    }
+
+    template <JsonHandler Handler>
+    PushStatus PushParser<Handler>::finish() {
+        if (status != PushStatus::need_more && status != PushStatus::complete)
+            return status;
+
+        // A bare top-level number or keyword only ends at end of input.
+        if (partial == Partial::literal && open_stack.empty()) {
+            partial = Partial::none;
+
+            if (!emitLiteral(pending, pending_offset))
+                return status;
+
+            pending.clear();
+        }
+
+        if (partial != Partial::none || expect != Expect::nothing)
+            return fail(ParseStatus::err_unexpected_eof, 0);
+
+        status = PushStatus::complete;
+
+        return status;
+    }
+
+    template <JsonHandler Handler>
+    void PushParser<Handler>::reset() {
+        open_stack.clear();
+        pending.clear();
+        scratch.clear();
+        consumed = 0;
+        error_offset = 0;
+        pending_offset = 0;
+        expect = Expect::value;
+        partial = Partial::none;
+        status = PushStatus::need_more;
+        error = ParseStatus::err_none;
+        pending_escape = false;
+        pending_has_escape = false;
+    }
+
+    template <JsonHandler Handler>
+    PushStatus PushParser<Handler>::fail(ParseStatus code, size_t chunk_pos) {
+        return failAt(code, consumed + chunk_pos);
+    }
+
+    template <JsonHandler Handler>
+    PushStatus PushParser<Handler>::failAt(ParseStatus code, size_t offset) {
+        status = PushStatus::failed;
+        error = code;
+        error_offset = offset;
+
+        return status;
+    }
+
+    template <JsonHandler Handler>
+    PushStatus PushParser<Handler>::stop() {
+        status = PushStatus::stopped;
+
+        return status;
+    }
+
+    /// @note Returns the index of the closing quote, or npos if the body runs past this chunk. A trailing lone backslash is remembered across chunks.
+    template <JsonHandler Handler>
+    size_t PushParser<Handler>::scanStringBody(std::string_view chunk, size_t pos) {
+        if (pending_escape) {
+            if (pos >= chunk.length())
+                return std::string_view::npos;
+
+            pending_escape = false;
+            pos++;
+        }
+
+        while (true) {
+            size_t hit = findQuoteOrBackslash(chunk, pos);
+
+            if (hit == std::string_view::npos)
+                return hit;
+
+            if (chunk[hit] == '\"')
+                return hit;
+
+            pending_has_escape = true;
+
+            if (hit + 1 >= chunk.length()) {
+                pending_escape = true;
+                return std::string_view::npos;
+            }
+
+            pos = hit + 2;
+        }
+    }
+
+    template <JsonHandler Handler>
+    bool PushParser<Handler>::emitString(std::string_view raw, bool is_key, bool has_escape, size_t offset) {
+        std::string_view text = raw;
+
+        if (has_escape) {
+            scratch.clear();
+
+            if (!appendDecoded(raw, scratch)) {
+                failAt(ParseStatus::err_bad_escape, offset);
+                return false;
+            }
+
+            text = scratch;
+        }
+
+        bool keep_going = is_key ? handler->onKey(text) : handler->onString(text);
+
+        if (!keep_going) {
+            stop();
+            return false;
+        }
+
+        if (is_key)
+            expect = Expect::colon;
+        else
+            afterValue();
+
+        return true;
+    }
+
+    template <JsonHandler Handler>
+    bool PushParser<Handler>::emitLiteral(std::string_view lexeme, size_t offset) {
+        bool keep_going = true;
+
+        if (isNumberStart(lexeme.front())) {
+            NumberLiteral number;
+
+            if (!parseNumber(lexeme, number)) {
+                failAt(ParseStatus::err_bad_number, offset);
+                return false;
+            }
+
+            keep_going = handler->onNumber(number);
+        } else {
+            TokenType type = lookupKeyword(lexeme);
+
+            if (type == TokenType::lt_null) {
+                keep_going = handler->onNull();
+            } else if (type == TokenType::lt_true || type == TokenType::lt_false) {
+                keep_going = handler->onBool(type == TokenType::lt_true);
+            } else {
+                failAt(ParseStatus::err_unknown_token, offset);
+                return false;
+            }
+        }
+
+        if (!keep_going) {
+            stop();
+            return false;
+        }
+
+        afterValue();
+
+        return true;
+    }
+
+    template <JsonHandler Handler>
+    bool PushParser<Handler>::closeContainer(TokenType closer, size_t chunk_pos) {
+        TokenType opener = (closer == TokenType::rbrace) ? TokenType::lbrace : TokenType::lbrack;
+
+        if (open_stack.empty() || open_stack.back() != opener) {
+            fail(ParseStatus::err_misplaced_token, chunk_pos);
+            return false;
+        }
+
+        open_stack.pop_back();
+
+        bool keep_going = (closer == TokenType::rbrace) ? handler->onEndObject() : handler->onEndArray();
+
+        if (!keep_going) {
+            stop();
+            return false;
+        }
+
+        afterValue();
+
+        return true;
+    }
+
+    template <JsonHandler Handler>
+    void PushParser<Handler>::afterValue() {
+        expect = open_stack.empty() ? Expect::nothing : Expect::comma_or_end;
+    }
+
+    /// @note Finishes the token split by the previous chunk. Returns false if it still is not complete or parsing ended.
+    template <JsonHandler Handler>
+    bool PushParser<Handler>::resumePartial(std::string_view chunk, size_t& pos) {
+        if (partial == Partial::literal) {
+            size_t end = 0;
+
+            while (end < chunk.length() && isLiteralSymbol(chunk[end]))
+                end++;
+
+            pending.append(chunk.substr(0, end));
+
+            if (end == chunk.length())
+                return false;
+
+            partial = Partial::none;
+            pos = end;
+
+            if (!emitLiteral(pending, pending_offset))
+                return false;
+
+            pending.clear();
+
+            return true;
+        }
+
+        size_t end = scanStringBody(chunk, 0);
+
+        if (end == std::string_view::npos) {
+            pending.append(chunk);
+            return false;
+        }
+
+        pending.append(chunk.substr(0, end));
+
+        bool is_key = partial == Partial::key;
+
+        partial = Partial::none;
+        pos = end + 1;
+
+        if (!emitString(pending, is_key, pending_has_escape, pending_offset))
+            return false;
+
+        pending.clear();
+
+        return true;
+    }
+
+    template <JsonHandler Handler>
+    bool PushParser<Handler>::stepToken(std::string_view chunk, size_t& pos) {
+        char c = chunk[pos];
+
+        switch (expect) {
+            case Expect::colon:
+                if (c != ':') {
+                    fail(ParseStatus::err_misplaced_token, pos);
+                    return false;
+                }
+
+                expect = Expect::value;
+                pos++;
+                return true;
+            case Expect::comma_or_end:
+                if (c == ',') {
+                    expect = (open_stack.back() == TokenType::lbrace) ? Expect::key : Expect::value;
+                    pos++;
+                    return true;
+                } else if (c == '}' || c == ']') {
+                    pos++;
+                    return closeContainer((c == '}') ? TokenType::rbrace : TokenType::rbrack, pos - 1);
+                }
+
+                fail(ParseStatus::err_misplaced_token, pos);
+                return false;
+            case Expect::key:
+            case Expect::key_or_end:
+                if (c == '}' && expect == Expect::key_or_end) {
+                    pos++;
+                    return closeContainer(TokenType::rbrace, pos - 1);
+                } else if (c != '\"') {
+                    fail(ParseStatus::err_misplaced_token, pos);
+                    return false;
+                }
+                break;
+            case Expect::nothing:
+                fail(ParseStatus::err_misplaced_token, pos);
+                return false;
+            default:
+                break;
+        }
+
+        bool is_key = expect == Expect::key || expect == Expect::key_or_end;
+
+        if (c == '\"') {
+            size_t begin = pos + 1;
+
+            pending_has_escape = false;
+            pending_escape = false;
+
+            size_t end = scanStringBody(chunk, begin);
+
+            if (end == std::string_view::npos) {
+                partial = is_key ? Partial::key : Partial::string;
+                pending.assign(chunk.substr(begin));
+                pending_offset = consumed + begin;
+                pos = chunk.length();
+                return false;
+            }
+
+            pos = end + 1;
+
+            return emitString(chunk.substr(begin, end - begin), is_key, pending_has_escape, consumed + begin);
+        }
+
+        if (c == ']' && expect == Expect::value_or_end) {
+            pos++;
+            return closeContainer(TokenType::rbrack, pos - 1);
+        }
+
+        if (c == '{' || c == '[') {
+            bool is_object = c == '{';
+
+            open_stack.push_back(is_object ? TokenType::lbrace : TokenType::lbrack);
+            expect = is_object ? Expect::key_or_end : Expect::value_or_end;
+            pos++;
+
+            if (!(is_object ? handler->onStartObject() : handler->onStartArray())) {
+                stop();
+                return false;
+            }
+
+            return true;
+        }
+
+        if (!isLiteralSymbol(c)) {
+            bool structural = c == '}' || c == ']' || c == ':' || c == ',';
+
+            fail(structural ? ParseStatus::err_misplaced_token : ParseStatus::err_unknown_token, pos);
+            return false;
+        }
+
+        size_t begin = pos;
+
+        while (pos < chunk.length() && isLiteralSymbol(chunk[pos]))
+            pos++;
+
+        if (pos == chunk.length()) {
+            partial = Partial::literal;
+            pending.assign(chunk.substr(begin));
+            pending_offset = consumed + begin;
+            return false;
+        }
+
+        return emitLiteral(chunk.substr(begin, pos - begin), consumed + begin);
+    }
+}
+
+#endif
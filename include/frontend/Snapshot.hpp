@@ -0,0 +1,59 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "data/Value.hpp"
+
+namespace toyjson::frontend {
+    /// @brief Bumped whenever the snapshot layout or TapeNode changes. Snapshots of any other version are ignored.
+    inline constexpr std::uint32_t snapshot_version = 1;
+
+    /// @brief Identifies the JSON file a snapshot was built from, so edits to it make the snapshot stale.
+    struct SourceStamp {
+        std::uint64_t bytes;
+        std::int64_t mtime_ns;
+    };
+
+    enum class SnapshotCheck {
+        header_only, // O(1): trusts the body once the header, sizes and stamp match
+        full         // also verifies the checksum and every node's bounds, reading the whole body once
+    };
+
+    enum class SnapshotOrigin {
+        mapped,  // a valid snapshot was mapped in place
+        reparsed // the JSON was parsed again, as the snapshot was missing, stale or invalid
+    };
+
+    struct SnapshotLoad {
+        data::ToyJsonDocument doc;
+        SnapshotOrigin origin;
+        bool refreshed; // a fresh snapshot was written after reparsing
+    };
+
+    /// @throws std::system_error if the file cannot be stat'ed.
+    [[nodiscard]] SourceStamp stampFile(const std::string& file_path_str);
+
+    /**
+     * @brief Writes any document as a binary snapshot: a versioned header, then its tape nodes and string pool exactly as a mapped tape reads them. Tree and lazy documents are flattened first.
+     * @note The file is written beside its final path and renamed over it, so readers never see a partial snapshot.
+     * @throws std::system_error if the snapshot cannot be written.
+     */
+    void writeSnapshot(const std::string& snapshot_path_str, const data::ToyJsonDocument& doc, SourceStamp stamp);
+
+    /**
+     * @brief Maps a snapshot and returns a tape document viewing it in place, with no deserialization pass.
+     * @return std::nullopt if the snapshot is missing, stale against the stamp, from another version or byte order, or fails the check.
+     */
+    [[nodiscard]] std::optional<data::ToyJsonDocument> openSnapshot(const std::string& snapshot_path_str, SourceStamp stamp, SnapshotCheck check = SnapshotCheck::full);
+
+    /**
+     * @brief Opens the snapshot of a JSON file if it is still valid, else parses the JSON and tries to refresh the snapshot for next time.
+     * @note A snapshot that cannot be written is not an error: the parsed document is returned with refreshed unset.
+     * @throws std::system_error if the JSON cannot be read, or std::runtime_error if it is malformed.
+     */
+    [[nodiscard]] SnapshotLoad loadWithSnapshot(const std::string& json_path_str, const std::string& snapshot_path_str, SnapshotCheck check = SnapshotCheck::full);
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef STRING_SCAN_HPP
+#define STRING_SCAN_HPP
+
+#include <cstddef>
+#include <string_view>
+
+namespace toyjson::frontend {
+    /// @brief Finds the first '\"' or '\\' at or after pos, 16 or 32 bytes at a time. Returns npos if there is none.
+    [[nodiscard]] size_t findQuoteOrBackslash(std::string_view text, size_t pos);
+
+    /// @brief Finds the first '\\' at or after pos. Returns npos if there is none.
+    [[nodiscard]] size_t findBackslash(std::string_view text, size_t pos);
+
+    /// @brief Finds the first '\"', '\\' or raw control character (below 0x20) at or after pos. Returns npos if there is none.
+    [[nodiscard]] size_t findStringSpecial(std::string_view text, size_t pos);
+
+    /// @brief Finds the closing quote of a string body starting at pos, stepping over escaped characters. Returns npos if unterminated.
+    [[nodiscard]] size_t findStringEnd(std::string_view text, size_t pos);
+
+    /**
+     * @brief Decodes the escape sequence starting at the backslash in raw[pos] into up to 4 UTF-8 bytes. \\uXXXX surrogate pairs are combined.
+     * @return Count of raw bytes consumed, or 0 for a malformed or lone-surrogate escape.
+     */
+    [[nodiscard]] size_t decodeEscape(std::string_view raw, size_t pos, char (&utf8_out)[4], size_t& utf8_length);
+
+    /**
+     * @brief Appends the unescaped form of a raw string body to out. Bodies without escapes are copied with a single append.
+     * @return false if the body holds a malformed escape.
+     */
+    template <typename StringT>
+    [[nodiscard]] bool appendDecoded(std::string_view raw, StringT& out) {
+        size_t pos = 0;
+        size_t escape_pos = findBackslash(raw, pos);
+
+        if (escape_pos == std::string_view::npos) {
+            out.append(raw);
+            return true;
+        }
+
+        out.reserve(out.length() + raw.length());
+
+        while (escape_pos != std::string_view::npos) {
+            out.append(raw.substr(pos, escape_pos - pos));
+
+            char utf8_buffer[4];
+            size_t utf8_length = 0;
+            size_t consumed = decodeEscape(raw, escape_pos, utf8_buffer, utf8_length);
+
+            if (consumed == 0)
+                return false;
+
+            out.append(utf8_buffer, utf8_length);
+
+            pos = escape_pos + consumed;
+            escape_pos = findBackslash(raw, pos);
+        }
+
+        out.append(raw.substr(pos));
+
+        return true;
+    }
+}
+
+#endif
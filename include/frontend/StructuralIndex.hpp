@@ -0,0 +1,64 @@
+#ifndef STRUCTURAL_INDEX_HPP
+#define STRUCTURAL_INDEX_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "utils/Simd.hpp"
+#include "frontend/Token.hpp"
+
+namespace toyjson::frontend {
+    /// @brief 12-byte token form for the indexed path. Offsets are 32-bit, so indexed inputs are capped at 4 GiB.
+    struct CompactToken {
+        std::uint32_t begin;
+        std::uint32_t length;
+        TokenType type;
+    };
+
+    [[nodiscard]] constexpr Token widenToken(const CompactToken& token) {
+        return {.begin = token.begin, .length = token.length, .type = token.type};
+    }
+
+    /**
+     * @brief Stage-1 scan: walks the input in 64-byte blocks and records the offset of every structural character outside strings, every unescaped quote, and the first byte of every bare literal. Whitespace never shows up in the index.
+     */
+    class StructuralIndex {
+        public:
+            static constexpr size_t max_input_size = UINT32_MAX;
+
+            StructuralIndex();
+
+            void build(std::string_view source);
+            void build(std::string_view source, utils::SimdLevel level);
+
+            [[nodiscard]] const std::vector<std::uint32_t>& getPositions() const;
+
+        private:
+            std::vector<std::uint32_t> positions;
+    };
+
+    /**
+     * @brief Token source over a StructuralIndex. It hops between indexed positions instead of visiting every byte.
+     */
+    class IndexedLexer {
+        public:
+            IndexedLexer() = delete;
+            IndexedLexer(std::string_view sv_arg);
+
+            /// @brief Reindexes new input, reusing the position buffer so inputs no larger than earlier ones cost no allocation.
+            void reset(std::string_view sv_arg);
+
+            [[nodiscard]] Token lexNext();
+            [[nodiscard]] CompactToken lexNextCompact();
+
+        private:
+            StructuralIndex index;
+            std::string_view symbols;
+            size_t cursor;
+
+            [[nodiscard]] CompactToken lexString(std::uint32_t begin);
+            [[nodiscard]] CompactToken lexLiteral(std::uint32_t begin);
+    };
+}
+
+#endif
@@ -1,12 +1,13 @@
 #ifndef TOKEN_HPP
 #define TOKEN_HPP
 
+#include <cstdint>
 #include <initializer_list>
 #include <string_view>
 #include <string>
 
 namespace toyjson::frontend {
-    enum class TokenType {
+    enum class TokenType : std::uint8_t {
         unknown,
         whitespace,
         lbrace,
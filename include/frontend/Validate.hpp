@@ -0,0 +1,24 @@
+#ifndef VALIDATE_HPP
+#define VALIDATE_HPP
+
+#include <cstddef>
+#include <string_view>
+#include "frontend/ParseResult.hpp"
+
+namespace toyjson::frontend {
+    /**
+     * @brief Deepest nesting validate() and the Parser accept. Open containers are tracked one bit each here, so the stack is a fixed 128-byte array.
+     * @note Kept low enough that the Parser's recursion, and the recursive teardown of the tree it builds, fit in a default thread stack even in debug builds.
+     */
+    inline constexpr size_t max_validate_depth = 1024;
+
+    /**
+     * @brief Checks that json_sv is one RFC 8259 value with only whitespace around it, without building anything or allocating.
+     * @note Stricter than the parsers, which let trailing commas and text after the root value through. String contents must be valid UTF-8 without raw control characters.
+     * Numbers are checked against the grammar only, since the parsers saturate out-of-range magnitudes to +-infinity or +-0 rather than rejecting them.
+     * @return The first error by offset, else success.
+     */
+    [[nodiscard]] ParseResult<void> validate(std::string_view json_sv);
+}
+
+#endif
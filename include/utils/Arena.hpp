@@ -0,0 +1,51 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace toyjson::utils {
+    /**
+     * @brief Bump allocator handing out memory from large blocks. Deallocation is a no-op and everything is released at once, either by reset() which keeps the blocks for the next document, or by destruction.
+     * @warning Not thread-safe. Only reset() once no document built from this arena is alive.
+     */
+    class Arena : public std::pmr::memory_resource {
+        public:
+            static constexpr size_t default_block_size = 64 * 1024;
+
+            Arena();
+            explicit Arena(size_t x_block_size);
+            ~Arena() override = default;
+
+            Arena(const Arena& other) = delete;
+            Arena& operator=(const Arena& other) = delete;
+
+            void reset();
+            void release();
+
+            [[nodiscard]] size_t getBytesUsed() const;
+            [[nodiscard]] size_t getBytesReserved() const;
+
+        private:
+            struct Block {
+                std::unique_ptr<std::byte[]> memory;
+                size_t size;
+            };
+
+            std::vector<Block> blocks;
+            size_t block_size;
+            size_t current;
+            size_t offset;
+            size_t used;
+
+            [[nodiscard]] void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+            [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+            [[nodiscard]] void* tryBump(size_t bytes, size_t alignment);
+    };
+}
+
+#endif
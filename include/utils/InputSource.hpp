@@ -0,0 +1,49 @@
+#ifndef INPUT_SOURCE_HPP
+#define INPUT_SOURCE_HPP
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace toyjson::utils {
+    enum class InputBacking {
+        mapped,   // read-only mmap of a regular file
+        buffered  // read() into an owned buffer, for pipes, ttys and stdin
+    };
+
+    /**
+     * @brief Read-only view of a whole input, mapped when possible so parsing reads the page cache directly with no copies.
+     * @note No padding is needed past the end: the SIMD kernels copy partial tail blocks into local buffers instead of over-reading.
+     */
+    class InputSource {
+        public:
+            InputSource() = delete;
+            InputSource(const InputSource& other) = delete;
+            InputSource& operator=(const InputSource& other) = delete;
+            ~InputSource();
+
+            /**
+             * @brief Opens a file, mapping it if it is a regular file. A path of "-" reads stdin.
+             * @param populate Prefault the whole mapping up front (MAP_POPULATE) instead of on first touch.
+             * @throws std::system_error if the file cannot be opened or read.
+             */
+            [[nodiscard]] static std::shared_ptr<const InputSource> open(const std::string& file_path_str, bool populate = false);
+
+            /// @brief Reads a descriptor until EOF without taking ownership of it.
+            [[nodiscard]] static std::shared_ptr<const InputSource> readDescriptor(int fd);
+
+            [[nodiscard]] std::string_view getText() const;
+            [[nodiscard]] InputBacking getBacking() const;
+
+        private:
+            std::string buffer;
+            const char* data;
+            size_t length;
+            InputBacking backing;
+
+            InputSource(const char* x_data, size_t x_length);
+            explicit InputSource(std::string x_buffer);
+    };
+}
+
+#endif
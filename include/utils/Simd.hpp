@@ -0,0 +1,33 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <string_view>
+
+// Vector kernels are only compiled for x86 with GCC/Clang, where they can be dispatched at runtime via target attributes.
+#if defined(TOYJSON_USE_SIMD) && (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TOYJSON_X86_SIMD 1
+#endif
+
+namespace toyjson::utils {
+    enum class SimdLevel {
+        scalar,
+        sse42,
+        avx2
+    };
+
+    /// @brief Returns the best instruction set usable on this CPU, detected once per process.
+    [[nodiscard]] SimdLevel detectSimdLevel();
+
+    [[nodiscard]] constexpr std::string_view toSimdName(SimdLevel level) {
+        using std::operator""sv;
+
+        if (level == SimdLevel::avx2)
+            return "AVX2"sv;
+        else if (level == SimdLevel::sse42)
+            return "SSE4.2"sv;
+
+        return "scalar"sv;
+    }
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <chrono>
+#include <cstddef>
+
+namespace toyjson::utils {
+    /// @brief True when built with USE_STATS. Instrumentation is guarded by `if constexpr` on this, so other builds carry no trace of it.
+#ifdef TOYJSON_USE_STATS
+    inline constexpr bool stats_enabled = true;
+#else
+    inline constexpr bool stats_enabled = false;
+#endif
+
+    /// @brief Running totals of global operator new and delete calls.
+    struct AllocTally {
+        size_t allocs;
+        size_t frees;
+        size_t bytes;
+    };
+
+    /**
+     * @brief Records one allocation or free in the tallies. Called by the global operator new and delete hooks in src/AllocHooks.cpp.
+     * @note The libraries never replace operator new themselves. Programs opt in by linking those hooks, as toyjson_bench always does and toyjson does with USE_STATS.
+     */
+    void countAlloc(size_t size) noexcept;
+    void countFree() noexcept;
+
+    /// @brief Totals for the calling thread only. Always zero unless the program links the allocation hooks.
+    [[nodiscard]] AllocTally readThreadAllocs();
+
+    /// @brief Totals across all threads. Always zero unless the program links the allocation hooks.
+    [[nodiscard]] AllocTally readProcessAllocs();
+
+    /**
+     * @brief Adds the time between construction and destruction to a total. Does nothing and reads no clock unless stats_enabled.
+     */
+    class StatTimer {
+        public:
+            StatTimer() = delete;
+
+            explicit StatTimer(std::chrono::nanoseconds& x_total)
+                : total {x_total}, start {} {
+                if constexpr (stats_enabled)
+                    start = std::chrono::steady_clock::now();
+            }
+
+            StatTimer(const StatTimer& other) = delete;
+            StatTimer& operator=(const StatTimer& other) = delete;
+
+            ~StatTimer() {
+                if constexpr (stats_enabled)
+                    total += std::chrono::steady_clock::now() - start;
+            }
+
+        private:
+            std::chrono::nanoseconds& total;
+            std::chrono::steady_clock::time_point start;
+    };
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace toyjson::utils {
+    /**
+     * @brief Fixed set of worker threads, each with its own task deque. Idle workers steal from the others, so uneven tasks still keep every core busy.
+     * @note Owners take from the front of their deque and thieves from the back. Tasks submitted in some order therefore start roughly in that order, and a task never waits behind one submitted after it on the same worker.
+     */
+    class ThreadPool {
+        public:
+            /// @brief Receives the index of the worker running it, for indexing per-worker state.
+            using Task = std::function<void(size_t)>;
+
+            ThreadPool() = delete;
+
+            /// @param worker_count Thread count, or 0 for one per hardware thread.
+            explicit ThreadPool(size_t worker_count);
+            ~ThreadPool();
+
+            ThreadPool(const ThreadPool& other) = delete;
+            ThreadPool& operator=(const ThreadPool& other) = delete;
+
+            /// @warning Tasks must not throw.
+            void submit(Task task);
+
+            /// @brief Blocks until every submitted task has finished.
+            void waitIdle();
+
+            [[nodiscard]] size_t getWorkerCount() const;
+
+        private:
+            struct WorkQueue {
+                std::mutex lock;
+                std::deque<Task> tasks;
+            };
+
+            std::vector<std::unique_ptr<WorkQueue>> queues;
+            std::vector<std::thread> workers;
+            std::mutex state_lock;
+            std::condition_variable wake;
+            std::condition_variable idle;
+            size_t queued;
+            size_t unfinished;
+            size_t next_queue;
+            bool stopping;
+
+            [[nodiscard]] bool tryTake(size_t worker_id, Task& task);
+            void runWorker(size_t worker_id);
+    };
+}
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef UTF8_HPP
+#define UTF8_HPP
+
+#include <cstddef>
+#include <string_view>
+
+namespace toyjson::utils {
+    /**
+     * @brief Finds the first byte that does not belong to a well-formed UTF-8 sequence, checking 32 or 64 bytes at a time. Overlong forms, surrogates and code points past U+10FFFF are all invalid.
+     * @return Offset of the lead byte of the first bad sequence, or of the stray byte itself, else npos.
+     */
+    [[nodiscard]] size_t findInvalidUtf8(std::string_view text);
+
+    /// @brief Byte-at-a-time form of findInvalidUtf8, starting at pos, which must begin a sequence.
+    [[nodiscard]] size_t findInvalidUtf8Scalar(std::string_view text, size_t pos);
+}
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @file AllocHooks.cpp
+ * @author DrkWithT
+ * @brief Replaces the global allocation functions with ones that feed the utils allocation counters.
+ * @date 2024-05-28
+ * @note Only linked into the toyjson_bench program, and into toyjson when built with USE_STATS. The libraries never replace a host program's allocator.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <cstdlib>
+#include <new>
+#include "utils/Stats.hpp"
+
+namespace {
+    void* allocateCounted(size_t size, size_t alignment) {
+        toyjson::utils::countAlloc(size);
+
+        if (size == 0)
+            size = 1;
+
+        void* block = (alignment <= alignof(std::max_align_t))
+            ? std::malloc(size)
+            : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+
+        if (block == nullptr)
+            throw std::bad_alloc {};
+
+        return block;
+    }
+
+    void freeCounted(void* block) noexcept {
+        if (block == nullptr)
+            return;
+
+        toyjson::utils::countFree();
+        std::free(block);
+    }
+}
+
+void* operator new(size_t size) {
+    return allocateCounted(size, alignof(std::max_align_t));
+}
+
+void* operator new[](size_t size) {
+    return allocateCounted(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return allocateCounted(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return allocateCounted(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* block) noexcept {
+    freeCounted(block);
+}
+
+void operator delete[](void* block) noexcept {
+    freeCounted(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    freeCounted(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+    freeCounted(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept {
+    freeCounted(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept {
+    freeCounted(block);
+}
+
+void operator delete(void* block, size_t, std::align_val_t) noexcept {
+    freeCounted(block);
+}
+
+void operator delete[](void* block, size_t, std::align_val_t) noexcept {
+    freeCounted(block);
+}
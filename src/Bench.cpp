@@ -0,0 +1,424 @@
+/**
+ * @file Bench.cpp
+ * @author DrkWithT
+ * @brief Entry point of the benchmark program.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+#include "utils/FileUtils.hpp"
+#include "utils/Simd.hpp"
+#include "data/Value.hpp"
+#include "frontend/Parser.hpp"
+#include "frontend/JsonLines.hpp"
+#include "frontend/Validate.hpp"
+#include "backend/Writer.hpp"
+#include "bench/Corpus.hpp"
+#include "bench/Measure.hpp"
+
+namespace bench = toyjson::bench;
+
+/* Results */
+
+struct PhaseResult {
+    std::string name;
+    std::vector<double> samples; // seconds per iteration
+    bench::AllocCounts allocs;   // from the first iteration
+};
+
+struct CorpusResult {
+    std::string name;
+    size_t bytes;
+    size_t docs;
+    size_t peak_rss_kb;
+    std::vector<PhaseResult> phases;
+};
+
+struct BenchOptions {
+    size_t size_mb = 8;
+    size_t iterations = 5;
+    size_t threads = 1;
+    std::vector<bench::CorpusKind> corpora {};
+    std::string json_path {};
+    std::string baseline_path {};
+};
+
+/* Baseline binding: only the fields compared are read back. */
+
+struct BaselinePhase {
+    std::string name;
+    double mb_per_s = 0.0;
+};
+
+struct BaselineCorpus {
+    std::string name;
+    std::vector<BaselinePhase> phases;
+};
+
+struct BaselineReport {
+    std::vector<BaselineCorpus> corpora;
+};
+
+template <>
+struct toyjson::frontend::JsonFields<BaselinePhase> {
+    static constexpr auto list = std::make_tuple(bindField("name", &BaselinePhase::name), bindField("mb_per_s", &BaselinePhase::mb_per_s));
+};
+
+template <>
+struct toyjson::frontend::JsonFields<BaselineCorpus> {
+    static constexpr auto list = std::make_tuple(bindField("name", &BaselineCorpus::name), bindField("phases", &BaselineCorpus::phases));
+};
+
+template <>
+struct toyjson::frontend::JsonFields<BaselineReport> {
+    static constexpr auto list = std::make_tuple(bindField("corpora", &BaselineReport::corpora));
+};
+
+/* Phases */
+
+// Folds traversal results so the walks cannot be optimized away.
+volatile size_t walk_sink = 0;
+
+[[nodiscard]] double getMedian(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+
+    return samples[samples.size() / 2];
+}
+
+[[nodiscard]] double toMbPerSecond(size_t bytes, double seconds) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0) / seconds;
+}
+
+/// @brief Times fn into phase, counting allocations only on the first sample.
+template <typename Fn>
+void samplePhase(PhaseResult& phase, Fn&& fn) {
+    auto counts_before = bench::readAllocCounts();
+    auto start = std::chrono::steady_clock::now();
+
+    fn();
+
+    auto stop = std::chrono::steady_clock::now();
+    auto counts_after = bench::readAllocCounts();
+
+    if (phase.samples.empty())
+        phase.allocs = counts_after - counts_before;
+
+    phase.samples.push_back(std::chrono::duration<double>(stop - start).count());
+}
+
+/// @return Nodes visited plus string lengths, so every value is actually read.
+[[nodiscard]] size_t walkValue(const toyjson::data::IJsonValue& value) {
+    return value.visit([](const auto& field) -> size_t {
+        using Field = std::remove_cvref_t<decltype(field)>;
+
+        if constexpr (std::is_same_v<Field, toyjson::data::BooleanField>) {
+            return 1 + field.asBoolean();
+        } else if constexpr (std::is_same_v<Field, toyjson::data::NumberField>) {
+            return 1 + (field.asDouble() > 0.0);
+        } else if constexpr (std::is_same_v<Field, toyjson::data::StringField>) {
+            return 1 + field.asString().length();
+        } else if constexpr (std::is_same_v<Field, toyjson::data::ArrayField>) {
+            size_t visited = 1;
+
+            for (const auto& item : field)
+                visited += walkValue(item);
+
+            return visited;
+        } else if constexpr (std::is_same_v<Field, toyjson::data::ObjectField>) {
+            size_t visited = 1;
+
+            for (const auto& member : field)
+                visited += member.key->text.length() + walkValue(*member.value);
+
+            return visited;
+        } else {
+            return 1;
+        }
+    });
+}
+
+/**
+ * @brief Runs every phase over one corpus. Each iteration goes lex, dom, traverse, serialize, teardown, tape and validate in turn, so the tree phases share one parse.
+ * @note dom excludes teardown, which is timed on its own. tape covers its parse and its drop, since tapes free in a fixed few calls.
+ */
+[[nodiscard]] CorpusResult runCorpus(const bench::Corpus& corpus, const BenchOptions& options) {
+    using toyjson::frontend::Parser;
+    using toyjson::frontend::TokenType;
+
+    CorpusResult result {.name = std::string {bench::toCorpusName(corpus.kind)}, .bytes = corpus.bytes, .docs = corpus.docs.size(), .peak_rss_kb = 0, .phases = {}};
+    std::vector<toyjson::data::ToyJsonDocument> docs;
+
+    for (const char* phase_name : {"lex", "dom", "traverse", "serialize", "teardown", "tape", "validate"})
+        result.phases.push_back(PhaseResult {.name = phase_name, .samples = {}, .allocs = {}});
+
+    if (corpus.kind == bench::CorpusKind::ndjson)
+        result.phases.push_back(PhaseResult {.name = "lines", .samples = {}, .allocs = {}});
+
+    docs.reserve(corpus.docs.size());
+    bench::resetPeakRss();
+
+    for (size_t iteration = 0; iteration < options.iterations; iteration++) {
+        samplePhase(result.phases[0], [&corpus]() {
+            size_t token_count = 0;
+
+            for (const auto& doc : corpus.docs) {
+                toyjson::frontend::IndexedLexer lexer {doc};
+
+                while (lexer.lexNext().type != TokenType::eof)
+                    token_count++;
+            }
+
+            walk_sink = walk_sink + token_count;
+        });
+
+        samplePhase(result.phases[1], [&corpus, &docs]() {
+            Parser parser {corpus.docs.front()};
+
+            for (const auto& doc : corpus.docs) {
+                parser.reset(doc);
+                docs.push_back(parser.parseToADT("bench"));
+            }
+        });
+
+        samplePhase(result.phases[2], [&docs]() {
+            size_t visited = 0;
+
+            for (const auto& doc : docs)
+                visited += walkValue(*doc.getRoot());
+
+            walk_sink = walk_sink + visited;
+        });
+
+        samplePhase(result.phases[3], [&docs]() {
+            size_t written = 0;
+
+            for (const auto& doc : docs)
+                written += toyjson::backend::serialize(doc).length();
+
+            walk_sink = walk_sink + written;
+        });
+
+        samplePhase(result.phases[4], [&docs]() {
+            docs.clear();
+        });
+
+        samplePhase(result.phases[5], [&corpus]() {
+            Parser parser {corpus.docs.front()};
+
+            for (const auto& doc : corpus.docs) {
+                parser.reset(doc);
+                (void)parser.parseToTape("bench");
+            }
+        });
+
+        samplePhase(result.phases[6], [&corpus]() {
+            size_t valid_count = 0;
+
+            for (const auto& doc : corpus.docs)
+                valid_count += toyjson::frontend::validate(doc).hasValue();
+
+            walk_sink = walk_sink + valid_count;
+        });
+
+        if (corpus.kind == bench::CorpusKind::ndjson) {
+            samplePhase(result.phases[7], [&corpus, &options]() {
+                toyjson::frontend::JsonLinesParser lines_parser {toyjson::frontend::JsonLinesOptions {.worker_count = options.threads}};
+
+                (void)lines_parser.parse(corpus.lines, []([[maybe_unused]] size_t line_index, [[maybe_unused]] toyjson::data::ToyJsonDocument& doc) {});
+            });
+        }
+    }
+
+    result.peak_rss_kb = bench::readPeakRssKb();
+
+    return result;
+}
+
+/* Reporting */
+
+void printResult(std::ostream& out, const CorpusResult& result, const BaselineReport* baseline) {
+    out << result.name << ": " << result.docs << " docs, " << std::fixed << std::setprecision(2)
+        << static_cast<double>(result.bytes) / (1024.0 * 1024.0) << " MB, peak RSS " << result.peak_rss_kb / 1024 << " MB\n";
+
+    const BaselineCorpus* old_corpus = nullptr;
+
+    if (baseline != nullptr) {
+        auto match = std::find_if(baseline->corpora.begin(), baseline->corpora.end(), [&result](const BaselineCorpus& entry) { return entry.name == result.name; });
+
+        if (match != baseline->corpora.end())
+            old_corpus = &*match;
+    }
+
+    for (const auto& phase : result.phases) {
+        double median = getMedian(phase.samples);
+        double mb_per_s = toMbPerSecond(result.bytes, median);
+
+        out << "  " << std::left << std::setw(10) << phase.name << std::right
+            << std::setw(10) << mb_per_s << " MB/s"
+            << std::setw(14) << static_cast<double>(result.docs) / median << " docs/s"
+            << std::setw(12) << phase.allocs.allocs << " allocs";
+
+        if (old_corpus != nullptr) {
+            auto old_phase = std::find_if(old_corpus->phases.begin(), old_corpus->phases.end(), [&phase](const BaselinePhase& entry) { return entry.name == phase.name; });
+
+            if (old_phase != old_corpus->phases.end() && old_phase->mb_per_s > 0.0)
+                out << std::showpos << std::setw(10) << (mb_per_s / old_phase->mb_per_s - 1.0) * 100.0 << std::noshowpos << "% vs baseline";
+        }
+
+        out << '\n';
+    }
+}
+
+void writeJsonReport(const std::vector<CorpusResult>& results, const BenchOptions& options) {
+    int fd = (options.json_path == "-") ? STDOUT_FILENO : ::open(options.json_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0)
+        throw std::system_error {errno, std::generic_category(), "Cannot open " + options.json_path};
+
+    toyjson::backend::JsonWriter writer {fd, toyjson::backend::WriteOptions {.style = toyjson::backend::WriteStyle::pretty, .indent_width = 2}};
+
+    writer.beginObject();
+    writer.writeKey("format").writeNumber(1);
+#ifdef TOYJSON_DEBUG_BUILD
+    writer.writeKey("build").writeString("debug");
+#else
+    writer.writeKey("build").writeString("release");
+#endif
+    writer.writeKey("simd").writeString(toyjson::utils::toSimdName(toyjson::utils::detectSimdLevel()));
+    writer.writeKey("size_mb").writeNumber(static_cast<std::uint64_t>(options.size_mb));
+    writer.writeKey("iterations").writeNumber(static_cast<std::uint64_t>(options.iterations));
+    writer.writeKey("corpora").beginArray();
+
+    for (const auto& result : results) {
+        writer.beginObject();
+        writer.writeKey("name").writeString(result.name);
+        writer.writeKey("bytes").writeNumber(static_cast<std::uint64_t>(result.bytes));
+        writer.writeKey("docs").writeNumber(static_cast<std::uint64_t>(result.docs));
+        writer.writeKey("peak_rss_kb").writeNumber(static_cast<std::uint64_t>(result.peak_rss_kb));
+        writer.writeKey("phases").beginArray();
+
+        for (const auto& phase : result.phases) {
+            double median = getMedian(phase.samples);
+
+            writer.beginObject();
+            writer.writeKey("name").writeString(phase.name);
+            writer.writeKey("best_s").writeNumber(*std::min_element(phase.samples.begin(), phase.samples.end()));
+            writer.writeKey("median_s").writeNumber(median);
+            writer.writeKey("mb_per_s").writeNumber(toMbPerSecond(result.bytes, median));
+            writer.writeKey("docs_per_s").writeNumber(static_cast<double>(result.docs) / median);
+            writer.writeKey("allocs").writeNumber(static_cast<std::uint64_t>(phase.allocs.allocs));
+            writer.writeKey("frees").writeNumber(static_cast<std::uint64_t>(phase.allocs.frees));
+            writer.writeKey("alloc_bytes").writeNumber(static_cast<std::uint64_t>(phase.allocs.bytes));
+            writer.endObject();
+        }
+
+        writer.endArray();
+        writer.endObject();
+    }
+
+    writer.endArray();
+    writer.endObject();
+    writer.flush();
+
+    if (fd != STDOUT_FILENO)
+        ::close(fd);
+}
+
+/// @brief Usage: toyjson_bench [--size-mb <n>] [--iterations <n>] [--threads <n>] [--corpus <name>]... [--json <file or ->] [--baseline <file>]
+[[nodiscard]] std::optional<BenchOptions> readOptions(int argc, char* argv[]) {
+    BenchOptions options {};
+
+    for (int arg_pos = 1; arg_pos < argc; arg_pos++) {
+        std::string_view arg {argv[arg_pos]};
+        bool has_value = arg_pos + 1 < argc;
+
+        if (arg == "--size-mb" && has_value) {
+            options.size_mb = std::strtoul(argv[++arg_pos], nullptr, 10);
+        } else if (arg == "--iterations" && has_value) {
+            options.iterations = std::max<size_t>(1, std::strtoul(argv[++arg_pos], nullptr, 10));
+        } else if (arg == "--threads" && has_value) {
+            options.threads = std::strtoul(argv[++arg_pos], nullptr, 10);
+        } else if (arg == "--corpus" && has_value) {
+            auto kind = bench::findCorpusKind(argv[++arg_pos]);
+
+            if (!kind)
+                return {};
+
+            options.corpora.push_back(*kind);
+        } else if (arg == "--json" && has_value) {
+            options.json_path = argv[++arg_pos];
+        } else if (arg == "--baseline" && has_value) {
+            options.baseline_path = argv[++arg_pos];
+        } else {
+            return {};
+        }
+    }
+
+    if (options.corpora.empty())
+        options.corpora.assign(std::begin(bench::all_corpus_kinds), std::end(bench::all_corpus_kinds));
+
+    return options;
+}
+
+int main(int argc, char* argv[]) {
+    auto options = readOptions(argc, argv);
+
+    if (!options) {
+        std::cerr << "Usage: toyjson_bench [--size-mb <n>] [--iterations <n>] [--threads <n>] [--corpus <name>]... [--json <file or ->] [--baseline <file>]\n"
+            << "Corpora: twitter, canada, nested, wide, small_docs, ndjson\n";
+        return 1;
+    }
+
+#ifdef TOYJSON_DEBUG_BUILD
+    std::cerr << "Warning: built with DEBUG_MODE, so figures reflect -O0 code.\n";
+#endif
+
+    try {
+        std::optional<BaselineReport> baseline;
+
+        if (!options->baseline_path.empty()) {
+            auto baseline_text = toyjson::utils::readFile(options->baseline_path);
+            toyjson::frontend::Parser baseline_parser {baseline_text};
+
+            baseline.emplace();
+            baseline_parser.parseInto(*baseline);
+        }
+
+        std::vector<CorpusResult> results;
+
+        for (auto kind : options->corpora) {
+            auto corpus = bench::generateCorpus(kind, options->size_mb * 1024 * 1024);
+
+            results.push_back(runCorpus(corpus, *options));
+            // A JSON report on stdout keeps it parseable by sending the table to stderr.
+            printResult((options->json_path == "-") ? std::cerr : std::cout, results.back(), baseline ? &*baseline : nullptr);
+        }
+
+        if (!options->json_path.empty())
+            writeJsonReport(results, *options);
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -8,14 +8,141 @@
  * 
  */
 
-#include <any>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
 #include "utils/FileUtils.hpp"
+#include "utils/Stats.hpp"
 #include "data/Value.hpp"
 #include "frontend/Parser.hpp"
+#include "frontend/DocumentCache.hpp"
+#include "frontend/JsonLines.hpp"
+#include "frontend/Validate.hpp"
+#include "backend/Writer.hpp"
+
+struct Faculty {
+    std::string name;
+    int age;
+    double rating;
+    bool tenure;
+    std::optional<std::string> courses;
+};
+
+template <>
+struct toyjson::frontend::JsonFields<Faculty> {
+    static constexpr auto list = std::make_tuple(
+        bindField("name", &Faculty::name),
+        bindField("age", &Faculty::age),
+        bindField("rating", &Faculty::rating),
+        bindField("tenure", &Faculty::tenure),
+        bindField("courses", &Faculty::courses)
+    );
+};
+
+/// @brief Usage: toyjson --stats <file>
+int runStats(const std::string& path) {
+    if constexpr (!toyjson::utils::stats_enabled)
+        std::cerr << "Note: stats are all zero unless configured with -DUSE_STATS=TRUE.\n";
+
+    try {
+        auto text = toyjson::utils::readFile(path);
+        toyjson::frontend::Parser parser {text};
+        auto result = parser.parseWithStats(path);
+
+        toyjson::frontend::printStats(std::cout, result.stats);
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
+
+/// @brief Usage: toyjson --lines <file or -> [--threads <n>] [--unordered]
+int runJsonLines(int argc, char* argv[]) {
+    using MyLinesParser = toyjson::frontend::JsonLinesParser;
+
+    toyjson::frontend::JsonLinesOptions options {};
+    std::string path;
+
+    for (int arg_pos = 1; arg_pos < argc; arg_pos++) {
+        std::string_view arg {argv[arg_pos]};
+
+        if (arg == "--lines" && arg_pos + 1 < argc) {
+            path = argv[++arg_pos];
+        } else if (arg == "--threads" && arg_pos + 1 < argc) {
+            options.worker_count = std::strtoul(argv[++arg_pos], nullptr, 10);
+        } else if (arg == "--unordered") {
+            options.order = toyjson::frontend::DeliveryOrder::unordered;
+        } else {
+            std::cerr << "Usage: toyjson --lines <file or -> [--threads <n>] [--unordered]\n       toyjson --stats <file>\n";
+            return 1;
+        }
+    }
+
+    try {
+        MyLinesParser lines_parser {options};
+
+        auto stats = lines_parser.parseFile(path, []([[maybe_unused]] size_t line_index, [[maybe_unused]] toyjson::data::ToyJsonDocument& doc) {});
+
+        // Empty input can finish within the clock's resolution.
+        double rate_scale = (stats.seconds > 0.0) ? 1.0 / stats.seconds : 0.0;
+
+        std::cout << "threads: " << lines_parser.getWorkerCount() << '\n'
+            << "records: " << stats.records << '\n'
+            << "seconds: " << stats.seconds << '\n'
+            << "records/s: " << static_cast<double>(stats.records) * rate_scale << '\n'
+            << "MB/s: " << static_cast<double>(stats.bytes) / (1024.0 * 1024.0) * rate_scale << '\n';
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
+
+/// @brief Checks that cache hits share one document, that a changed mtime forces a reparse, and that entries past the budget are evicted.
+[[nodiscard]] bool checkDocumentCache(std::string_view sample_text) {
+    namespace fs = std::filesystem;
+
+    auto path = fs::temp_directory_path() / "toyjson_cache_check.json";
+
+    std::ofstream {path} << sample_text;
+
+    toyjson::frontend::DocumentCache cache {};
+    auto first = cache.get(path.string());
+    auto second = cache.get(path.string());
+    auto shared_stats = cache.getStats();
+
+    fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds {1});
+
+    auto reparsed = cache.get(path.string());
+    auto reparsed_stats = cache.getStats();
+
+    toyjson::frontend::DocumentCache tiny_cache {toyjson::frontend::DocumentCacheOptions {.byte_budget = 1}};
+    auto evicted = tiny_cache.get(path.string());
+    auto tiny_stats = tiny_cache.getStats();
+
+    fs::remove(path);
+
+    return first == second && shared_stats.hits == 1 && shared_stats.misses == 1
+        && reparsed != first && reparsed_stats.misses == 2
+        && evicted != nullptr && tiny_stats.evictions == 1 && tiny_stats.entries == 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && std::string_view {argv[1]} == "--stats")
+        return runStats(argv[2]);
+
+    if (argc > 1)
+        return runJsonLines(argc, argv);
 
-int main() {
-    using MyJsonAny = toyjson::data::AnyField;
     using MyJsonObj = toyjson::data::ObjectField;
     using MyParser = toyjson::frontend::Parser;
 
@@ -26,9 +153,14 @@ int main() {
     MyParser parser {flat_content};
 
     auto result = parser.parseToADT(name);
-    auto result_root = result.getRoot()->toBoxedValue();
-    MyJsonAny root_wrapper = std::any_cast<MyJsonAny>(result_root);
-    MyJsonObj root_obj = root_wrapper.unpackValue<MyJsonObj>();
+    const MyJsonObj* root_ptr = result.getRoot()->getIf<MyJsonObj>();
+
+    if (root_ptr == nullptr) {
+        std::cerr << "Result root is not an object!\n";
+        return 1;
+    }
+
+    const MyJsonObj& root_obj = *root_ptr;
 
     if (root_obj.isEmpty()) {
         std::cerr << "Result unexpectedly empty!\n";
@@ -44,4 +176,52 @@ int main() {
         std::cerr << "Result missing age property!\n";
         return 1;
     }
+
+    MyParser tape_parser {flat_content};
+
+    auto tape_result = tape_parser.parseToTape(name);
+    auto tape_root = tape_result.getTape().getRoot();
+
+    if (tape_root.getPropertyCount() != 6 || tape_root.getValuePtr("age").asNumber() != 35.0) {
+        std::cerr << "Unexpected tape contents!\n";
+        return 1;
+    }
+
+    auto compact_text = toyjson::backend::serialize(result);
+    MyParser reparser {compact_text};
+
+    if (toyjson::backend::serialize(reparser.parseToADT(name)) != compact_text) {
+        std::cerr << "Serialized text does not round-trip!\n";
+        return 1;
+    }
+
+    Faculty faculty {};
+    MyParser bind_parser {flat_content};
+
+    bind_parser.parseInto(faculty);
+
+    if (faculty.name != "Bob Jones" || faculty.age != 35 || !faculty.tenure || faculty.courses.has_value()) {
+        std::cerr << "Unexpected bound struct contents!\n";
+        return 1;
+    }
+
+    MyParser bad_parser {"{\"age\": [1, 2"};
+    auto bad_result = bad_parser.tryParseToADT(name);
+
+    if (bad_result || bad_result.getError().status != toyjson::frontend::ParseStatus::err_unexpected_eof) {
+        std::cerr << "Truncated input was not reported!\n";
+        return 1;
+    }
+
+    auto trailing_comma = toyjson::frontend::validate("[1, 2,]");
+
+    if (!toyjson::frontend::validate(flat_content) || trailing_comma || trailing_comma.getError().offset != 6) {
+        std::cerr << "Unexpected validation results!\n";
+        return 1;
+    }
+
+    if (!checkDocumentCache(flat_content)) {
+        std::cerr << "Unexpected document cache behavior!\n";
+        return 1;
+    }
 }
\ No newline at end of file
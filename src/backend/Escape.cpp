@@ -0,0 +1,142 @@
+/**
+ * @file Escape.cpp
+ * @author DrkWithT
+ * @brief Implements vectorized string escaping for output.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <bit>
+#include <cstdint>
+#include "utils/Simd.hpp"
+#include "backend/Escape.hpp"
+
+#ifdef TOYJSON_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace toyjson::backend {
+    namespace {
+        constexpr size_t npos = std::string_view::npos;
+
+        using FindEscapeFn = size_t (*)(const char* data, size_t length, size_t pos);
+
+        [[nodiscard]] constexpr bool needsEscape(char c) {
+            return c == '\"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+        }
+
+        size_t findEscapeScalar(const char* data, size_t length, size_t pos) {
+            for (; pos < length; pos++) {
+                if (needsEscape(data[pos]))
+                    return pos;
+            }
+
+            return npos;
+        }
+
+#ifdef TOYJSON_X86_SIMD
+        // A byte is a control character exactly when max(byte, 0x1F) is still 0x1F, compared unsigned.
+        __attribute__((target("sse2"))) size_t findEscapeSse2(const char* data, size_t length, size_t pos) {
+            const __m128i quote_v = _mm_set1_epi8('\"');
+            const __m128i backslash_v = _mm_set1_epi8('\\');
+            const __m128i control_v = _mm_set1_epi8(0x1F);
+
+            for (; pos + 16 <= length; pos += 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+                __m128i controls = _mm_cmpeq_epi8(_mm_max_epu8(chunk, control_v), control_v);
+                __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote_v), _mm_cmpeq_epi8(chunk, backslash_v)), controls);
+                auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(hits));
+
+                if (bits != 0)
+                    return pos + std::countr_zero(bits);
+            }
+
+            return findEscapeScalar(data, length, pos);
+        }
+
+        __attribute__((target("avx2"))) size_t findEscapeAvx2(const char* data, size_t length, size_t pos) {
+            const __m256i quote_v = _mm256_set1_epi8('\"');
+            const __m256i backslash_v = _mm256_set1_epi8('\\');
+            const __m256i control_v = _mm256_set1_epi8(0x1F);
+
+            for (; pos + 32 <= length; pos += 32) {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+                __m256i controls = _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, control_v), control_v);
+                __m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote_v), _mm256_cmpeq_epi8(chunk, backslash_v)), controls);
+                auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+
+                if (bits != 0)
+                    return pos + std::countr_zero(bits);
+            }
+
+            // The tail runs legacy-encoded SSE, which stalls on dirty upper AVX state unless it is cleared first.
+            _mm256_zeroupper();
+
+            return findEscapeSse2(data, length, pos);
+        }
+#endif
+
+        FindEscapeFn pickFindEscape() {
+#ifdef TOYJSON_X86_SIMD
+            if (utils::detectSimdLevel() == utils::SimdLevel::avx2)
+                return findEscapeAvx2;
+
+            return findEscapeSse2;
+#else
+            return findEscapeScalar;
+#endif
+        }
+
+        /// @brief Appends the escape for one byte that needsEscape().
+        void appendEscape(char c, std::string& out) {
+            constexpr const char* hex_digits = "0123456789abcdef";
+
+            switch (c) {
+                case '\"': out.append("\\\""); break;
+                case '\\': out.append("\\\\"); break;
+                case '\b': out.append("\\b"); break;
+                case '\f': out.append("\\f"); break;
+                case '\n': out.append("\\n"); break;
+                case '\r': out.append("\\r"); break;
+                case '\t': out.append("\\t"); break;
+                default: {
+                    auto code = static_cast<unsigned char>(c);
+                    const char unit[6] {'\\', 'u', '0', '0', hex_digits[code >> 4], hex_digits[code & 0x0F]};
+
+                    out.append(unit, sizeof(unit));
+                    break;
+                }
+            }
+        }
+    }
+
+    size_t findEscapeChar(std::string_view text, size_t pos) {
+        static const FindEscapeFn find_fn = pickFindEscape();
+
+        return find_fn(text.data(), text.length(), pos);
+    }
+
+    void appendEscaped(std::string_view text, std::string& out) {
+        size_t pos = 0;
+        size_t escape_pos = findEscapeChar(text, pos);
+
+        if (escape_pos == npos) {
+            out.append(text);
+            return;
+        }
+
+        out.reserve(out.length() + text.length() + 8);
+
+        while (escape_pos != npos) {
+            out.append(text.substr(pos, escape_pos - pos));
+            appendEscape(text[escape_pos], out);
+
+            pos = escape_pos + 1;
+            escape_pos = findEscapeChar(text, pos);
+        }
+
+        out.append(text.substr(pos));
+    }
+}
@@ -0,0 +1,381 @@
+/**
+ * @file Writer.cpp
+ * @author DrkWithT
+ * @brief Implements the streaming JSON writer and tree serialization.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <unistd.h>
+#include "backend/Escape.hpp"
+#include "backend/Writer.hpp"
+
+namespace toyjson::backend {
+    /* Usings */
+    using JsonNull = toyjson::data::NullField;
+    using JsonBoolean = toyjson::data::BooleanField;
+    using JsonNumber = toyjson::data::NumberField;
+    using JsonString = toyjson::data::StringField;
+    using JsonArray = toyjson::data::ArrayField;
+    using JsonObject = toyjson::data::ObjectField;
+    using JsonAny = toyjson::data::AnyField;
+
+    namespace {
+        constexpr int no_fd = -1;
+
+        /// @brief Room for any to_chars result: 20 digits and a sign for integers, or 24 characters for a shortest double.
+        constexpr size_t number_buffer_size = 32;
+
+        template <typename Field>
+        void writeScalar(JsonWriter& writer, const Field& field) {
+            if constexpr (std::is_same_v<Field, JsonNull>) {
+                writer.writeNull();
+            } else if constexpr (std::is_same_v<Field, JsonBoolean>) {
+                writer.writeBoolean(field.asBoolean());
+            } else if constexpr (std::is_same_v<Field, JsonString>) {
+                writer.writeString(field.asString());
+            } else {
+                if (field.getNumberKind() == data::NumberKind::j_int64)
+                    writer.writeNumber(field.asInt64());
+                else if (field.getNumberKind() == data::NumberKind::j_uint64)
+                    writer.writeNumber(field.asUInt64());
+                else
+                    writer.writeNumber(field.asDouble());
+            }
+        }
+
+        void writeArray(JsonWriter& writer, const JsonArray& array) {
+            writer.beginArray();
+
+            for (size_t pos = 0; pos < array.getLength(); pos++)
+                writer.writeValue(*array.getItemPtr(pos));
+
+            writer.endArray();
+        }
+
+        void writeObject(JsonWriter& writer, const JsonObject& object) {
+            writer.beginObject();
+
+            for (const auto& member : object.getProperties()) {
+                writer.writeKey(member.key->text);
+                writer.writeValue(*member.value);
+            }
+
+            writer.endObject();
+        }
+
+        void writeAny(JsonWriter& writer, const JsonAny& any) {
+            switch (any.getValueType()) {
+                case data::JsonType::j_null:
+                    writer.writeNull();
+                    break;
+                case data::JsonType::j_boolean:
+                    writeScalar(writer, any.unpackValue<JsonBoolean>());
+                    break;
+                case data::JsonType::j_number:
+                    writeScalar(writer, any.unpackValue<JsonNumber>());
+                    break;
+                case data::JsonType::j_string:
+                    writeScalar(writer, any.unpackValue<JsonString>());
+                    break;
+                case data::JsonType::j_array:
+                    writeArray(writer, any.unpackValue<JsonArray>());
+                    break;
+                case data::JsonType::j_object:
+                    writeObject(writer, any.unpackValue<JsonObject>());
+                    break;
+                default:
+                    throw std::runtime_error {"Cannot serialize a nested AnyField"};
+            }
+        }
+    }
+
+    /* JsonWriter */
+
+    JsonWriter::JsonWriter(WriteOptions x_options)
+        : buffer {}, levels {}, options {x_options}, fd {no_fd}, after_key {false}, complete {false} {}
+
+    JsonWriter::JsonWriter(int x_fd, WriteOptions x_options)
+        : buffer {}, levels {}, options {x_options}, fd {x_fd}, after_key {false}, complete {false} {
+        buffer.reserve(flush_threshold + flush_threshold / 4);
+    }
+
+    JsonWriter& JsonWriter::beginObject() {
+        beginContainer(true, '{');
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::endObject() {
+        endContainer(true, '}');
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::beginArray() {
+        beginContainer(false, '[');
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::endArray() {
+        endContainer(false, ']');
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::writeKey(std::string_view key) {
+        if (levels.empty() || !levels.back().is_object || after_key)
+            throw std::runtime_error {"Key written outside an object or twice in a row"};
+
+        Level& level = levels.back();
+
+        if (level.has_items)
+            buffer.push_back(',');
+
+        if (options.style == WriteStyle::pretty)
+            breakLine(levels.size());
+
+        level.has_items = true;
+
+        appendQuoted(key);
+        buffer.push_back(':');
+
+        if (options.style == WriteStyle::pretty)
+            buffer.push_back(' ');
+
+        after_key = true;
+
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::writeNull() {
+        beforeValue();
+        buffer.append("null");
+        afterValue();
+
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::writeBoolean(bool flag) {
+        beforeValue();
+        buffer.append(flag ? "true" : "false");
+        afterValue();
+
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::writeNumber(double num) {
+        if (!std::isfinite(num))
+            return writeNull();
+
+        beforeValue();
+
+        char digits[number_buffer_size];
+        auto [end_ptr, status] = std::to_chars(digits, digits + number_buffer_size, num);
+        std::string_view text {digits, static_cast<size_t>(end_ptr - digits)};
+
+        buffer.append(text);
+
+        // Shortest form drops the fraction of integral doubles, which would then reparse as integers.
+        if (text.find_first_of(".e") == std::string_view::npos)
+            buffer.append(".0");
+
+        afterValue();
+
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::writeNumber(int num) {
+        return writeNumber(static_cast<std::int64_t>(num));
+    }
+
+    JsonWriter& JsonWriter::writeNumber(std::int64_t num) {
+        beforeValue();
+
+        char digits[number_buffer_size];
+        auto [end_ptr, status] = std::to_chars(digits, digits + number_buffer_size, num);
+
+        buffer.append(digits, end_ptr);
+        afterValue();
+
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::writeNumber(std::uint64_t num) {
+        beforeValue();
+
+        char digits[number_buffer_size];
+        auto [end_ptr, status] = std::to_chars(digits, digits + number_buffer_size, num);
+
+        buffer.append(digits, end_ptr);
+        afterValue();
+
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::writeString(std::string_view text) {
+        beforeValue();
+        appendQuoted(text);
+        afterValue();
+
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::writeValue(const data::IJsonValue& value) {
+        switch (value.getType()) {
+            case data::JsonType::j_any:
+                writeAny(*this, static_cast<const JsonAny&>(value));
+                break;
+            case data::JsonType::j_null:
+                writeNull();
+                break;
+            case data::JsonType::j_boolean:
+                writeScalar(*this, static_cast<const JsonBoolean&>(value));
+                break;
+            case data::JsonType::j_number:
+                writeScalar(*this, static_cast<const JsonNumber&>(value));
+                break;
+            case data::JsonType::j_string:
+                writeScalar(*this, static_cast<const JsonString&>(value));
+                break;
+            case data::JsonType::j_array:
+                writeArray(*this, static_cast<const JsonArray&>(value));
+                break;
+            case data::JsonType::j_object:
+                writeObject(*this, static_cast<const JsonObject&>(value));
+                break;
+        }
+
+        return *this;
+    }
+
+    void JsonWriter::flush() {
+        if (fd == no_fd)
+            return;
+
+        size_t written = 0;
+
+        while (written < buffer.length()) {
+            ssize_t put = ::write(fd, buffer.data() + written, buffer.length() - written);
+
+            if (put < 0) {
+                if (errno == EINTR)
+                    continue;
+
+                throw std::system_error {errno, std::generic_category(), "Cannot write output"};
+            }
+
+            written += static_cast<size_t>(put);
+        }
+
+        buffer.clear();
+    }
+
+    bool JsonWriter::isComplete() const {
+        return complete;
+    }
+
+    std::string_view JsonWriter::getText() const {
+        return buffer;
+    }
+
+    std::string JsonWriter::releaseText() {
+        std::string x_text = std::move(buffer);
+
+        buffer.clear();
+
+        return x_text;
+    }
+
+    void JsonWriter::beforeValue() {
+        if (complete)
+            throw std::runtime_error {"Value written after the top-level value ended"};
+
+        if (levels.empty() || after_key) {
+            after_key = false;
+            return;
+        }
+
+        Level& level = levels.back();
+
+        if (level.is_object)
+            throw std::runtime_error {"Value written where a key is expected"};
+
+        if (level.has_items)
+            buffer.push_back(',');
+
+        if (options.style == WriteStyle::pretty)
+            breakLine(levels.size());
+
+        level.has_items = true;
+    }
+
+    void JsonWriter::afterValue() {
+        if (levels.empty())
+            complete = true;
+
+        if (fd != no_fd && buffer.length() >= flush_threshold)
+            flush();
+    }
+
+    void JsonWriter::beginContainer(bool is_object, char opener) {
+        beforeValue();
+        buffer.push_back(opener);
+        levels.push_back(Level {.is_object = is_object, .has_items = false});
+    }
+
+    void JsonWriter::endContainer(bool is_object, char closer) {
+        if (levels.empty() || levels.back().is_object != is_object || after_key)
+            throw std::runtime_error {"Container end does not match the open container"};
+
+        bool had_items = levels.back().has_items;
+
+        levels.pop_back();
+
+        if (had_items && options.style == WriteStyle::pretty)
+            breakLine(levels.size());
+
+        buffer.push_back(closer);
+        afterValue();
+    }
+
+    void JsonWriter::breakLine(size_t depth) {
+        buffer.push_back('\n');
+        buffer.append(depth * options.indent_width, ' ');
+    }
+
+    void JsonWriter::appendQuoted(std::string_view text) {
+        buffer.push_back('\"');
+        appendEscaped(text, buffer);
+        buffer.push_back('\"');
+    }
+
+    /* Tree serialization */
+
+    std::string serialize(const data::ToyJsonDocument& doc, WriteOptions options) {
+        if (doc.getStorageMode() != data::StorageMode::tree || !doc.getRoot())
+            throw std::runtime_error {"Only tree documents can be serialized"};
+
+        JsonWriter writer {options};
+
+        writer.writeValue(*doc.getRoot());
+
+        return writer.releaseText();
+    }
+
+    void serializeTo(int fd, const data::ToyJsonDocument& doc, WriteOptions options) {
+        if (doc.getStorageMode() != data::StorageMode::tree || !doc.getRoot())
+            throw std::runtime_error {"Only tree documents can be serialized"};
+
+        JsonWriter writer {fd, options};
+
+        writer.writeValue(*doc.getRoot());
+        writer.flush();
+    }
+}
@@ -0,0 +1,345 @@
+/**
+ * @file Corpus.cpp
+ * @author DrkWithT
+ * @brief Implements the deterministic benchmark corpus generators.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <array>
+#include <cstdio>
+#include <utility>
+#include "backend/Writer.hpp"
+#include "bench/Corpus.hpp"
+
+namespace toyjson::bench {
+    namespace {
+        /// @brief splitmix64, so a seed alone fixes the stream on every platform.
+        class Random {
+            public:
+                explicit Random(std::uint64_t x_state)
+                    : state {x_state} {}
+
+                [[nodiscard]] std::uint64_t next() {
+                    std::uint64_t mixed = (state += 0x9E3779B97F4A7C15ULL);
+
+                    mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                    mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+
+                    return mixed ^ (mixed >> 31);
+                }
+
+                /// @brief Uniform in [0, bound).
+                [[nodiscard]] std::uint64_t below(std::uint64_t bound) {
+                    return next() % bound;
+                }
+
+                /// @brief Uniform in [low, high).
+                [[nodiscard]] double between(double low, double high) {
+                    return low + (high - low) * (static_cast<double>(next() >> 11) * 0x1.0p-53);
+                }
+
+                [[nodiscard]] bool chance(std::uint64_t percent) {
+                    return below(100) < percent;
+                }
+
+            private:
+                std::uint64_t state;
+        };
+
+        constexpr std::array<std::string_view, 24> words {
+            "json", "parser", "fast", "token", "value", "stream", "tree", "tape",
+            "array", "object", "lorem", "ipsum", "dolor", "sit", "amet", "river",
+            "north", "coffee", "release", "build", "cache", "query", "bench", "night"
+        };
+
+        // Multi-byte UTF-8 mixed into text: accented Latin, CJK and an emoji.
+        constexpr std::array<std::string_view, 4> wide_chars {
+            "\xC3\xA9t\xC3\xA9", "\xE6\x97\xA5\xE6\x9C\xAC", "\xF0\x9F\x98\x80", "na\xC3\xAFve"
+        };
+
+        constexpr std::array<std::string_view, 6> languages {"en", "ja", "es", "fr", "de", "und"};
+
+        [[nodiscard]] std::string makeSentence(Random& random, size_t word_count) {
+            std::string text;
+
+            for (size_t word = 0; word < word_count; word++) {
+                if (word > 0)
+                    text.push_back(' ');
+
+                if (random.chance(8))
+                    text.append(wide_chars[random.below(wide_chars.size())]);
+                else if (random.chance(3))
+                    text.append("\"quoted\"\n");
+                else
+                    text.append(words[random.below(words.size())]);
+            }
+
+            return text;
+        }
+
+        [[nodiscard]] std::string makeName(Random& random, std::string_view prefix) {
+            std::string name {prefix};
+
+            name.append(words[random.below(words.size())]);
+            name.append(std::to_string(random.below(100000)));
+
+            return name;
+        }
+
+        [[nodiscard]] std::string makeTimestamp(Random& random) {
+            char text[32];
+            int length = std::snprintf(text, sizeof(text), "2024-%02d-%02dT%02d:%02d:%02dZ",
+                static_cast<int>(1 + random.below(12)), static_cast<int>(1 + random.below(28)),
+                static_cast<int>(random.below(24)), static_cast<int>(random.below(60)), static_cast<int>(random.below(60)));
+
+            return std::string {text, static_cast<size_t>(length)};
+        }
+
+        void writeUser(backend::JsonWriter& writer, Random& random) {
+            auto user_id = random.next() >> 12;
+
+            writer.beginObject();
+            writer.writeKey("id").writeNumber(user_id);
+            writer.writeKey("id_str").writeString(std::to_string(user_id));
+            writer.writeKey("name").writeString(makeName(random, ""));
+            writer.writeKey("screen_name").writeString(makeName(random, "@"));
+            writer.writeKey("location").writeString(random.chance(30) ? "" : makeSentence(random, 2));
+            writer.writeKey("description").writeString(makeSentence(random, 4 + random.below(16)));
+            writer.writeKey("url");
+
+            if (random.chance(50))
+                writer.writeNull();
+            else
+                writer.writeString("https://example.com/" + makeName(random, ""));
+
+            writer.writeKey("followers_count").writeNumber(static_cast<std::int64_t>(random.below(2000000)));
+            writer.writeKey("friends_count").writeNumber(static_cast<std::int64_t>(random.below(5000)));
+            writer.writeKey("verified").writeBoolean(random.chance(5));
+            writer.writeKey("created_at").writeString(makeTimestamp(random));
+            writer.endObject();
+        }
+
+        void writeEntities(backend::JsonWriter& writer, Random& random) {
+            writer.beginObject();
+            writer.writeKey("hashtags").beginArray();
+
+            for (auto tag = random.below(4); tag > 0; tag--) {
+                auto start = static_cast<std::int64_t>(random.below(100));
+
+                writer.beginObject();
+                writer.writeKey("text").writeString(words[random.below(words.size())]);
+                writer.writeKey("indices").beginArray().writeNumber(start).writeNumber(start + 8).endArray();
+                writer.endObject();
+            }
+
+            writer.endArray();
+            writer.writeKey("urls").beginArray().endArray();
+            writer.writeKey("user_mentions").beginArray();
+
+            for (auto mention = random.below(3); mention > 0; mention--) {
+                writer.beginObject();
+                writer.writeKey("screen_name").writeString(makeName(random, ""));
+                writer.writeKey("id").writeNumber(random.next() >> 12);
+                writer.endObject();
+            }
+
+            writer.endArray();
+            writer.endObject();
+        }
+
+        [[nodiscard]] std::string makeTwitter(Random& random, size_t target_bytes) {
+            backend::JsonWriter writer {};
+
+            writer.beginObject().writeKey("statuses").beginArray();
+
+            while (writer.getText().length() < target_bytes) {
+                auto status_id = random.next() >> 8;
+
+                writer.beginObject();
+                writer.writeKey("created_at").writeString(makeTimestamp(random));
+                writer.writeKey("id").writeNumber(status_id);
+                writer.writeKey("id_str").writeString(std::to_string(status_id));
+                writer.writeKey("text").writeString(makeSentence(random, 6 + random.below(20)));
+                writer.writeKey("truncated").writeBoolean(false);
+                writer.writeKey("entities");
+                writeEntities(writer, random);
+                writer.writeKey("user");
+                writeUser(writer, random);
+                writer.writeKey("in_reply_to_status_id").writeNull();
+                writer.writeKey("retweet_count").writeNumber(static_cast<std::int64_t>(random.below(10000)));
+                writer.writeKey("favorite_count").writeNumber(static_cast<std::int64_t>(random.below(50000)));
+                writer.writeKey("lang").writeString(languages[random.below(languages.size())]);
+                writer.endObject();
+            }
+
+            writer.endArray();
+            writer.writeKey("search_metadata").beginObject();
+            writer.writeKey("count").writeNumber(100);
+            writer.writeKey("query").writeString("bench");
+            writer.endObject().endObject();
+
+            return writer.releaseText();
+        }
+
+        [[nodiscard]] std::string makeCanada(Random& random, size_t target_bytes) {
+            backend::JsonWriter writer {};
+
+            writer.beginObject().writeKey("type").writeString("FeatureCollection");
+            writer.writeKey("features").beginArray();
+            writer.beginObject().writeKey("type").writeString("Feature");
+            writer.writeKey("properties").beginObject().writeKey("name").writeString("Canada").endObject();
+            writer.writeKey("geometry").beginObject().writeKey("type").writeString("Polygon");
+            writer.writeKey("coordinates").beginArray();
+
+            while (writer.getText().length() < target_bytes) {
+                double lon = random.between(-141.0, -52.0);
+                double lat = random.between(41.0, 83.0);
+
+                writer.beginArray();
+
+                for (auto point = 32 + random.below(480); point > 0; point--) {
+                    lon += random.between(-0.01, 0.01);
+                    lat += random.between(-0.01, 0.01);
+                    writer.beginArray().writeNumber(lon).writeNumber(lat).endArray();
+                }
+
+                writer.endArray();
+            }
+
+            writer.endArray().endObject().endObject();
+            writer.endArray().endObject();
+
+            return writer.releaseText();
+        }
+
+        void writeNested(backend::JsonWriter& writer, Random& random, size_t depth) {
+            if (depth == 0) {
+                writer.writeNumber(static_cast<std::int64_t>(random.below(1000)));
+                return;
+            }
+
+            if (depth % 2 == 0) {
+                writer.beginObject();
+                writer.writeKey("level").writeNumber(static_cast<std::int64_t>(depth));
+                writer.writeKey("child");
+                writeNested(writer, random, depth - 1);
+                writer.endObject();
+            } else {
+                writer.beginArray();
+                writer.writeBoolean(random.chance(50));
+                writeNested(writer, random, depth - 1);
+                writer.endArray();
+            }
+        }
+
+        [[nodiscard]] std::string makeNested(Random& random, size_t target_bytes) {
+            backend::JsonWriter writer {};
+
+            writer.beginArray();
+
+            while (writer.getText().length() < target_bytes)
+                writeNested(writer, random, 32 + random.below(224));
+
+            writer.endArray();
+
+            return writer.releaseText();
+        }
+
+        [[nodiscard]] std::string makeWide(Random& random, size_t target_bytes) {
+            constexpr size_t member_count = 512;
+            backend::JsonWriter writer {};
+            char key[16];
+
+            writer.beginArray();
+
+            while (writer.getText().length() < target_bytes) {
+                writer.beginObject();
+
+                for (size_t member = 0; member < member_count; member++) {
+                    int length = std::snprintf(key, sizeof(key), "field_%04zu", member);
+
+                    writer.writeKey(std::string_view {key, static_cast<size_t>(length)});
+
+                    switch (member % 4) {
+                        case 0: writer.writeNumber(static_cast<std::int64_t>(random.below(1000000))); break;
+                        case 1: writer.writeString(words[random.below(words.size())]); break;
+                        case 2: writer.writeBoolean(random.chance(50)); break;
+                        default: writer.writeNumber(random.between(0.0, 1000.0)); break;
+                    }
+                }
+
+                writer.endObject();
+            }
+
+            writer.endArray();
+
+            return writer.releaseText();
+        }
+
+        [[nodiscard]] std::string makeEvent(Random& random, size_t event_index) {
+            backend::JsonWriter writer {};
+
+            writer.beginObject();
+            writer.writeKey("seq").writeNumber(static_cast<std::uint64_t>(event_index));
+            writer.writeKey("time").writeString(makeTimestamp(random));
+            writer.writeKey("level").writeString(random.chance(90) ? "info" : "warn");
+            writer.writeKey("host").writeString(makeName(random, "node-"));
+            writer.writeKey("latency_ms").writeNumber(random.between(0.1, 250.0));
+            writer.writeKey("ok").writeBoolean(random.chance(97));
+            writer.writeKey("message").writeString(makeSentence(random, 3 + random.below(12)));
+            writer.writeKey("tags").beginArray();
+
+            for (auto tag = random.below(4); tag > 0; tag--)
+                writer.writeString(words[random.below(words.size())]);
+
+            writer.endArray();
+            writer.endObject();
+
+            return writer.releaseText();
+        }
+    }
+
+    std::optional<CorpusKind> findCorpusKind(std::string_view name) {
+        for (CorpusKind kind : all_corpus_kinds) {
+            if (toCorpusName(kind) == name)
+                return kind;
+        }
+
+        return {};
+    }
+
+    Corpus generateCorpus(CorpusKind kind, size_t target_bytes, std::uint64_t seed) {
+        Random random {seed ^ static_cast<std::uint64_t>(kind)};
+        Corpus corpus {.kind = kind, .docs = {}, .lines = {}, .bytes = 0};
+
+        switch (kind) {
+            case CorpusKind::twitter: corpus.docs.push_back(makeTwitter(random, target_bytes)); break;
+            case CorpusKind::canada: corpus.docs.push_back(makeCanada(random, target_bytes)); break;
+            case CorpusKind::nested: corpus.docs.push_back(makeNested(random, target_bytes)); break;
+            case CorpusKind::wide: corpus.docs.push_back(makeWide(random, target_bytes)); break;
+            case CorpusKind::small_docs:
+            case CorpusKind::ndjson:
+                while (corpus.bytes < target_bytes) {
+                    corpus.docs.push_back(makeEvent(random, corpus.docs.size()));
+                    corpus.bytes += corpus.docs.back().length();
+                }
+                break;
+        }
+
+        corpus.bytes = 0;
+
+        for (const auto& doc : corpus.docs) {
+            corpus.bytes += doc.length();
+
+            if (kind == CorpusKind::ndjson) {
+                corpus.lines.append(doc);
+                corpus.lines.push_back('\n');
+            }
+        }
+
+        return corpus;
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ * @file Measure.cpp
+ * @author DrkWithT
+ * @brief Implements allocation counting and peak RSS sampling for benchmarks.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/resource.h>
+#include "utils/Stats.hpp"
+#include "bench/Measure.hpp"
+
+namespace toyjson::bench {
+    /// @note The counts come from the allocation hooks in src/AllocHooks.cpp, which the benchmark program links.
+    AllocCounts readAllocCounts() {
+        auto tally = utils::readProcessAllocs();
+
+        return AllocCounts {.allocs = tally.allocs, .frees = tally.frees, .bytes = tally.bytes};
+    }
+
+    /// @note Writing 5 to clear_refs resets VmHWM on Linux 4.0 and later.
+    bool resetPeakRss() {
+        std::ofstream clear_refs {"/proc/self/clear_refs"};
+
+        if (!clear_refs)
+            return false;
+
+        clear_refs << "5";
+
+        return static_cast<bool>(clear_refs.flush());
+    }
+
+    size_t readPeakRssKb() {
+        std::ifstream status {"/proc/self/status"};
+        std::string line;
+
+        while (std::getline(status, line)) {
+            if (line.starts_with("VmHWM:"))
+                return std::strtoull(line.c_str() + 6, nullptr, 10);
+        }
+
+        rusage usage {};
+
+        getrusage(RUSAGE_SELF, &usage);
+
+        return static_cast<size_t>(usage.ru_maxrss);
+    }
+}
@@ -0,0 +1,101 @@
+/**
+ * @file KeyTable.cpp
+ * @author DrkWithT
+ * @brief Implements the object key intern table.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <cstring>
+#include <functional>
+#include "data/KeyTable.hpp"
+
+namespace toyjson::data {
+    namespace {
+        constexpr size_t initial_slot_count = 64;
+    }
+
+    KeyTable::KeyTable()
+        : KeyTable(std::pmr::get_default_resource()) {}
+
+    KeyTable::KeyTable(std::pmr::memory_resource* resource)
+        : table_lock {}, storage {resource}, slots {initial_slot_count, nullptr, resource}, count {0} {}
+
+    size_t KeyTable::hashKey(std::string_view text) {
+        return std::hash<std::string_view> {}(text);
+    }
+
+    Key KeyTable::intern(std::string_view text) {
+        return intern(text, hashKey(text));
+    }
+
+    Key KeyTable::intern(std::string_view text, size_t hash) {
+        std::lock_guard<std::mutex> guard {table_lock};
+
+        size_t slot = findSlot(text, hash);
+
+        if (slots[slot] != nullptr)
+            return slots[slot];
+
+        // Text and entry share one bump allocation, so a key costs a single slot and never moves.
+        auto* entry_ptr = static_cast<KeyEntry*>(storage.allocate(sizeof(KeyEntry) + text.length(), alignof(KeyEntry)));
+        char* text_ptr = reinterpret_cast<char*>(entry_ptr + 1);
+
+        if (!text.empty())
+            std::memcpy(text_ptr, text.data(), text.length());
+
+        Key entry = new (entry_ptr) KeyEntry {.text = std::string_view {text_ptr, text.length()}, .hash = hash};
+
+        slots[slot] = entry;
+        count++;
+
+        if (count * 2 > slots.size())
+            grow();
+
+        return entry;
+    }
+
+    Key KeyTable::lookup(std::string_view text) const {
+        std::lock_guard<std::mutex> guard {table_lock};
+
+        return slots[findSlot(text, hashKey(text))];
+    }
+
+    size_t KeyTable::getSize() const {
+        std::lock_guard<std::mutex> guard {table_lock};
+
+        return count;
+    }
+
+    size_t KeyTable::findSlot(std::string_view text, size_t hash) const {
+        size_t mask = slots.size() - 1;
+        size_t slot = hash & mask;
+
+        while (slots[slot] != nullptr && (slots[slot]->hash != hash || slots[slot]->text != text))
+            slot = (slot + 1) & mask;
+
+        return slot;
+    }
+
+    void KeyTable::grow() {
+        std::pmr::vector<Key> old_slots {slots.size() * 2, nullptr, slots.get_allocator()};
+
+        old_slots.swap(slots);
+
+        size_t mask = slots.size() - 1;
+
+        for (Key entry : old_slots) {
+            if (entry == nullptr)
+                continue;
+
+            size_t slot = entry->hash & mask;
+
+            while (slots[slot] != nullptr)
+                slot = (slot + 1) & mask;
+
+            slots[slot] = entry;
+        }
+    }
+}
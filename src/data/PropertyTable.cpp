@@ -0,0 +1,176 @@
+/**
+ * @file PropertyTable.cpp
+ * @author DrkWithT
+ * @brief Implements the insertion-ordered object member table.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <bit>
+#include <utility>
+#include "data/PropertyTable.hpp"
+
+namespace toyjson::data {
+    namespace {
+        constexpr size_t no_pos = static_cast<size_t>(-1);
+    }
+
+    PropertyTable::PropertyTable()
+        : keys {}, members {}, slots {} {}
+
+    PropertyTable::PropertyTable(std::shared_ptr<KeyTable> x_keys, std::pmr::memory_resource* resource)
+        : keys {std::move(x_keys)}, members {resource}, slots {resource} {}
+
+    bool PropertyTable::insert(Key key, std::shared_ptr<IJsonValue> value, DuplicateKeyPolicy policy) {
+        size_t found = findPosition(key);
+
+        if (found != no_pos) {
+            if (policy == DuplicateKeyPolicy::keep_last)
+                members[found].value = std::move(value);
+
+            return policy != DuplicateKeyPolicy::reject;
+        }
+
+        members.push_back(Property {.key = key, .value = std::move(value)});
+
+        // The index keeps at most half its slots full so probe runs stay short.
+        if (members.size() > hash_threshold && members.size() * 2 > slots.size())
+            rebuildIndex(std::bit_ceil(members.size() * 4));
+        else if (!slots.empty())
+            indexMember(members.size() - 1);
+
+        return true;
+    }
+
+    bool PropertyTable::insert(std::string_view key, std::shared_ptr<IJsonValue> value, DuplicateKeyPolicy policy) {
+        if (!keys)
+            keys = std::make_shared<KeyTable>();
+
+        return insert(keys->intern(key), std::move(value), policy);
+    }
+
+    bool PropertyTable::merge(PropertyTable& other, DuplicateKeyPolicy policy) {
+        bool merged = true;
+
+        if (!keys)
+            keys = other.keys;
+
+        bool same_keys = keys == other.keys;
+
+        members.reserve(members.size() + other.members.size());
+
+        for (auto& member : other.members) {
+            Key key = same_keys ? member.key : keys->intern(member.key->text, member.key->hash);
+
+            if (!insert(key, std::move(member.value), policy)) {
+                merged = false;
+                break;
+            }
+        }
+
+        other.members.clear();
+        other.slots.clear();
+
+        return merged;
+    }
+
+    void PropertyTable::reserve(size_t count) {
+        members.reserve(count);
+    }
+
+    const Property* PropertyTable::find(std::string_view key) const {
+        size_t found = findPosition(key);
+
+        return (found != no_pos) ? &members[found] : nullptr;
+    }
+
+    const Property* PropertyTable::find(Key key) const {
+        size_t found = findPosition(key);
+
+        return (found != no_pos) ? &members[found] : nullptr;
+    }
+
+    const std::shared_ptr<KeyTable>& PropertyTable::getKeyTable() const {
+        return keys;
+    }
+
+    bool PropertyTable::isEmpty() const {
+        return members.empty();
+    }
+
+    size_t PropertyTable::getSize() const {
+        return members.size();
+    }
+
+    PropertyTable::const_iterator PropertyTable::begin() const {
+        return members.begin();
+    }
+
+    PropertyTable::const_iterator PropertyTable::end() const {
+        return members.end();
+    }
+
+    size_t PropertyTable::findPosition(std::string_view key) const {
+        if (slots.empty()) {
+            for (size_t member_pos = 0; member_pos < members.size(); member_pos++) {
+                std::string_view member_key = members[member_pos].key->text;
+
+                if (member_key.length() == key.length() && member_key == key)
+                    return member_pos;
+            }
+
+            return no_pos;
+        }
+
+        size_t hash = KeyTable::hashKey(key);
+        size_t mask = slots.size() - 1;
+
+        for (size_t slot = hash & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+            Key member_key = members[slots[slot] - 1].key;
+
+            if (member_key->hash == hash && member_key->text == key)
+                return slots[slot] - 1;
+        }
+
+        return no_pos;
+    }
+
+    size_t PropertyTable::findPosition(Key key) const {
+        if (slots.empty()) {
+            for (size_t member_pos = 0; member_pos < members.size(); member_pos++) {
+                if (members[member_pos].key == key)
+                    return member_pos;
+            }
+
+            return no_pos;
+        }
+
+        size_t mask = slots.size() - 1;
+
+        for (size_t slot = key->hash & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+            if (members[slots[slot] - 1].key == key)
+                return slots[slot] - 1;
+        }
+
+        return no_pos;
+    }
+
+    void PropertyTable::rebuildIndex(size_t slot_count) {
+        slots.assign(slot_count, 0);
+
+        for (size_t member_pos = 0; member_pos < members.size(); member_pos++)
+            indexMember(member_pos);
+    }
+
+    void PropertyTable::indexMember(size_t member_pos) {
+        size_t mask = slots.size() - 1;
+        size_t slot = members[member_pos].key->hash & mask;
+
+        while (slots[slot] != 0)
+            slot = (slot + 1) & mask;
+
+        slots[slot] = static_cast<std::uint32_t>(member_pos + 1);
+    }
+}
@@ -0,0 +1,322 @@
+/**
+ * @file Query.cpp
+ * @author DrkWithT
+ * @brief Implements JSON Pointer and JSONPath compilation.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <utility>
+#include "data/Query.hpp"
+
+namespace toyjson::data {
+    namespace {
+        constexpr size_t npos = std::string_view::npos;
+
+        [[nodiscard]] PathStep makeStep(PathStepKind kind) {
+            return PathStep {.kind = kind, .name = {}, .index = -1, .start = 0, .end = 0, .stride = 1, .has_start = false, .has_end = false};
+        }
+
+        [[noreturn]] void throwPathError(const char* syntax, size_t pos, const char* msg) {
+            throw std::runtime_error {std::string {"Invalid "} + syntax + " at position " + std::to_string(pos) + ": " + msg};
+        }
+
+        /// @brief Reads an optionally signed integer at text[pos], advancing pos. Returns false if there are no digits.
+        [[nodiscard]] bool readInteger(std::string_view text, size_t& pos, std::int64_t& out) {
+            const char* begin = text.data() + pos;
+            auto [end_ptr, status] = std::from_chars(begin, text.data() + text.length(), out);
+
+            if (status != std::errc {})
+                return false;
+
+            pos += static_cast<size_t>(end_ptr - begin);
+
+            return true;
+        }
+
+        /// @brief Array index per RFC 6901: "0" or digits without a leading zero. Returns -1 for anything else, "-" included.
+        [[nodiscard]] std::int64_t readPointerIndex(std::string_view token) {
+            if (token.empty() || (token.length() > 1 && token.front() == '0'))
+                return -1;
+
+            std::int64_t index = 0;
+            auto [end_ptr, status] = std::from_chars(token.data(), token.data() + token.length(), index);
+
+            if (status != std::errc {} || end_ptr != token.data() + token.length() || index < 0)
+                return -1;
+
+            return index;
+        }
+
+        [[nodiscard]] constexpr bool isNameSymbol(char c) {
+            return c != '.' && c != '[' && c != ']' && c != ' ' && c != '\'' && c != '\"';
+        }
+    }
+
+    /* PathQuery */
+
+    PathQuery::PathQuery(std::vector<PathStep> x_steps)
+        : steps(std::move(x_steps)) {}
+
+    PathQuery PathQuery::compilePointer(std::string_view pointer) {
+        std::vector<PathStep> x_steps;
+
+        if (pointer.empty())
+            return PathQuery {std::move(x_steps)};
+
+        if (pointer.front() != '/')
+            throwPathError("JSON Pointer", 0, "must be empty or start with '/'");
+
+        size_t pos = 1;
+
+        while (true) {
+            size_t token_end = std::min(pointer.find('/', pos), pointer.length());
+            PathStep step = makeStep(PathStepKind::member);
+
+            for (size_t cursor = pos; cursor < token_end; cursor++) {
+                if (pointer[cursor] != '~') {
+                    step.name.push_back(pointer[cursor]);
+                    continue;
+                }
+
+                char code = (cursor + 1 < token_end) ? pointer[cursor + 1] : '\0';
+
+                if (code != '0' && code != '1')
+                    throwPathError("JSON Pointer", cursor, "'~' must be followed by '0' or '1'");
+
+                step.name.push_back(code == '0' ? '~' : '/');
+                cursor++;
+            }
+
+            step.index = readPointerIndex(step.name);
+            x_steps.push_back(std::move(step));
+
+            if (token_end == pointer.length())
+                break;
+
+            pos = token_end + 1;
+        }
+
+        return PathQuery {std::move(x_steps)};
+    }
+
+    PathQuery PathQuery::compilePath(std::string_view path) {
+        constexpr const char* syntax = "JSONPath";
+        std::vector<PathStep> x_steps;
+
+        if (path.empty() || path.front() != '$')
+            throwPathError(syntax, 0, "must start with '$'");
+
+        size_t pos = 1;
+
+        while (pos < path.length()) {
+            if (path[pos] == '.') {
+                pos++;
+
+                if (pos < path.length() && path[pos] == '*') {
+                    x_steps.push_back(makeStep(PathStepKind::wildcard));
+                    pos++;
+                    continue;
+                }
+
+                if (pos < path.length() && path[pos] == '.')
+                    throwPathError(syntax, pos, "recursive descent is not supported");
+
+                size_t name_end = pos;
+
+                while (name_end < path.length() && isNameSymbol(path[name_end]))
+                    name_end++;
+
+                if (name_end == pos)
+                    throwPathError(syntax, pos, "expected a member name");
+
+                PathStep step = makeStep(PathStepKind::member);
+
+                step.name.assign(path.substr(pos, name_end - pos));
+                x_steps.push_back(std::move(step));
+                pos = name_end;
+                continue;
+            }
+
+            if (path[pos] != '[')
+                throwPathError(syntax, pos, "expected '.' or '['");
+
+            pos++;
+
+            if (pos < path.length() && (path[pos] == '\'' || path[pos] == '\"')) {
+                char quote = path[pos++];
+                PathStep step = makeStep(PathStepKind::member);
+
+                while (pos < path.length() && path[pos] != quote) {
+                    if (path[pos] == '\\' && pos + 1 < path.length())
+                        pos++;
+
+                    step.name.push_back(path[pos++]);
+                }
+
+                if (pos + 1 >= path.length() || path[pos + 1] != ']')
+                    throwPathError(syntax, pos, "unterminated quoted name");
+
+                x_steps.push_back(std::move(step));
+                pos += 2;
+                continue;
+            }
+
+            if (pos < path.length() && path[pos] == '*') {
+                if (pos + 1 >= path.length() || path[pos + 1] != ']')
+                    throwPathError(syntax, pos, "expected ']' after '*'");
+
+                x_steps.push_back(makeStep(PathStepKind::wildcard));
+                pos += 2;
+                continue;
+            }
+
+            PathStep step = makeStep(PathStepKind::index);
+            std::int64_t number = 0;
+
+            step.has_start = readInteger(path, pos, number);
+            step.start = number;
+
+            if (pos < path.length() && path[pos] == ':') {
+                step.kind = PathStepKind::slice;
+                pos++;
+
+                step.has_end = readInteger(path, pos, number);
+                step.end = number;
+
+                if (pos < path.length() && path[pos] == ':') {
+                    pos++;
+
+                    if (readInteger(path, pos, number))
+                        step.stride = number;
+                }
+
+                if (step.stride == 0)
+                    throwPathError(syntax, pos, "slice stride cannot be 0");
+            } else if (step.has_start) {
+                step.index = step.start;
+            } else {
+                throwPathError(syntax, pos, "expected a name, index, slice or '*'");
+            }
+
+            if (pos >= path.length() || path[pos] != ']')
+                throwPathError(syntax, pos, "expected ']'");
+
+            x_steps.push_back(std::move(step));
+            pos++;
+        }
+
+        return PathQuery {std::move(x_steps)};
+    }
+
+    const std::vector<PathStep>& PathQuery::getSteps() const {
+        return steps;
+    }
+
+    bool PathQuery::isSingular() const {
+        return std::none_of(steps.begin(), steps.end(), [](const PathStep& step) {
+            return step.kind == PathStepKind::wildcard || step.kind == PathStepKind::slice;
+        });
+    }
+
+    const IJsonValue* PathQuery::find(const IJsonValue& root) const {
+        const IJsonValue* found = nullptr;
+
+        (void)forEach(root, [&found](const IJsonValue& match) {
+            found = &match;
+            return false;
+        });
+
+        return found;
+    }
+
+    std::optional<TapeValue> PathQuery::find(TapeValue root) const {
+        std::optional<TapeValue> found;
+
+        (void)forEach(root, [&found](TapeValue match) {
+            found = match;
+            return false;
+        });
+
+        return found;
+    }
+
+    const ArrayField* PathQuery::asArray(const IJsonValue* value) {
+        return value->getIf<ArrayField>();
+    }
+
+    const ObjectField* PathQuery::asObject(const IJsonValue* value) {
+        return value->getIf<ObjectField>();
+    }
+
+    size_t PathQuery::resolveIndex(std::int64_t index, size_t length) {
+        auto signed_length = static_cast<std::int64_t>(length);
+
+        if (index < 0)
+            index += signed_length;
+
+        return (index >= 0 && index < signed_length) ? static_cast<size_t>(index) : npos;
+    }
+
+    /// @note Bounds follow RFC 9535: negative bounds count from the end, then clamp to the array. last is moved onto the stride so the loop can stop on equality.
+    void PathQuery::resolveSlice(const PathStep& step, size_t length, std::int64_t& first, std::int64_t& last) {
+        auto signed_length = static_cast<std::int64_t>(length);
+        auto normalize = [signed_length](std::int64_t bound) { return (bound >= 0) ? bound : signed_length + bound; };
+
+        if (step.stride > 0) {
+            first = step.has_start ? std::clamp<std::int64_t>(normalize(step.start), 0, signed_length) : 0;
+            last = step.has_end ? std::clamp<std::int64_t>(normalize(step.end), 0, signed_length) : signed_length;
+        } else {
+            first = step.has_start ? std::clamp<std::int64_t>(normalize(step.start), -1, signed_length - 1) : signed_length - 1;
+            last = step.has_end ? std::clamp<std::int64_t>(normalize(step.end), -1, signed_length - 1) : -1;
+        }
+
+        std::int64_t span = (step.stride > 0) ? last - first : first - last;
+        std::int64_t stride_size = (step.stride > 0) ? step.stride : -step.stride;
+        std::int64_t count = (span > 0) ? (span + stride_size - 1) / stride_size : 0;
+
+        last = first + count * step.stride;
+    }
+
+    /* QueryBatch */
+
+    QueryBatch::QueryBatch()
+        : nodes {}, query_count {0} {
+        nodes.push_back(TrieNode {.step = makeStep(PathStepKind::wildcard), .children = {}, .query_ids = {}});
+    }
+
+    size_t QueryBatch::add(const PathQuery& query) {
+        std::uint32_t node_pos = 0;
+
+        for (const auto& step : query.getSteps()) {
+            auto& children = nodes[node_pos].children;
+            auto shared = std::find_if(children.begin(), children.end(), [this, &step](std::uint32_t child_pos) {
+                return nodes[child_pos].step == step;
+            });
+
+            if (shared != children.end()) {
+                node_pos = *shared;
+                continue;
+            }
+
+            auto child_pos = static_cast<std::uint32_t>(nodes.size());
+
+            nodes[node_pos].children.push_back(child_pos);
+            nodes.push_back(TrieNode {.step = step, .children = {}, .query_ids = {}});
+            node_pos = child_pos;
+        }
+
+        nodes[node_pos].query_ids.push_back(static_cast<std::uint32_t>(query_count));
+
+        return query_count++;
+    }
+
+    size_t QueryBatch::getQueryCount() const {
+        return query_count;
+    }
+}
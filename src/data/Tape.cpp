@@ -0,0 +1,420 @@
+/**
+ * @file Tape.cpp
+ * @author DrkWithT
+ * @brief Implements the flat tape document storage.
+ * @date 2024-05-20
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <bit>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include "data/Tape.hpp"
+
+namespace toyjson::data {
+    /* TapeState */
+
+    struct TapeState {
+        std::vector<TapeNode> nodes;
+        std::string strings;
+        std::span<const TapeNode> mapped_nodes; // used instead of nodes and strings when not empty
+        std::string_view mapped_strings;
+        std::string_view source;
+        const ScalarCodec* codec;
+        mutable std::mutex decode_guard;        // memo for lazily unescaped strings
+        mutable std::unordered_map<std::uint32_t, std::string> decoded;
+
+        TapeState(std::vector<TapeNode> x_nodes, std::string x_strings, std::string_view x_source, const ScalarCodec* x_codec)
+            : nodes(std::move(x_nodes)), strings(std::move(x_strings)), mapped_nodes {}, mapped_strings {}, source {x_source}, codec {x_codec}, decode_guard {}, decoded {} {}
+
+        TapeState(std::span<const TapeNode> x_mapped_nodes, std::string_view x_mapped_strings)
+            : nodes {}, strings {}, mapped_nodes {x_mapped_nodes}, mapped_strings {x_mapped_strings}, source {}, codec {nullptr}, decode_guard {}, decoded {} {}
+
+        [[nodiscard]] std::span<const TapeNode> getNodes() const {
+            if (!mapped_nodes.empty())
+                return mapped_nodes;
+
+            return nodes;
+        }
+
+        [[nodiscard]] std::string_view getStringPool() const {
+            if (!mapped_nodes.empty())
+                return mapped_strings;
+
+            return strings;
+        }
+
+        [[nodiscard]] const TapeNode& getNodeAt(std::uint32_t node_index) const {
+            return mapped_nodes.empty() ? nodes[node_index] : mapped_nodes[node_index];
+        }
+
+        [[nodiscard]] std::uint32_t getNextIndex(std::uint32_t node_index) const {
+            const auto& node = getNodeAt(node_index);
+
+            if (node.type == JsonType::j_array || node.type == JsonType::j_object)
+                return static_cast<std::uint32_t>(node.payload);
+
+            return node_index + 1;
+        }
+
+        [[nodiscard]] std::string_view viewRaw(const TapeNode& node) const {
+            if ((node.flags & tape_lazy_bit) != 0)
+                return source.substr(node.payload, node.length);
+
+            return getStringPool().substr(node.payload, node.length);
+        }
+
+        /// @note Escaped lazy strings are unescaped on first access and memoized, so repeated reads return the same view.
+        [[nodiscard]] std::string_view viewString(std::uint32_t node_index) const {
+            const auto& node = getNodeAt(node_index);
+
+            if ((node.flags & tape_escaped_bit) == 0)
+                return viewRaw(node);
+
+            std::lock_guard lock {decode_guard};
+
+            auto cached = decoded.find(node_index);
+
+            if (cached != decoded.end())
+                return cached->second;
+
+            std::string text;
+
+            if (!codec->decode_string(viewRaw(node), text))
+                throw std::runtime_error {"Lazy tape string has a malformed escape"};
+
+            return decoded.emplace(node_index, std::move(text)).first->second;
+        }
+    };
+
+    /* TapeValue */
+
+    TapeValue::TapeValue(const TapeState* x_state, std::uint32_t x_index)
+        : state {x_state}, index {x_index} {}
+
+    JsonType TapeValue::getType() const {
+        return getNode().type;
+    }
+
+    bool TapeValue::asBoolean() const {
+        if (getType() != JsonType::j_boolean)
+            throw std::runtime_error {"Tape value is not a boolean"};
+
+        return getNode().payload != 0;
+    }
+
+    double TapeValue::asNumber() const {
+        NumberKind kind;
+        std::uint64_t bits;
+
+        loadNumber(kind, bits);
+
+        if (kind == NumberKind::j_int64)
+            return static_cast<double>(static_cast<std::int64_t>(bits));
+        else if (kind == NumberKind::j_uint64)
+            return static_cast<double>(bits);
+
+        return std::bit_cast<double>(bits);
+    }
+
+    NumberKind TapeValue::getNumberKind() const {
+        NumberKind kind;
+        std::uint64_t bits;
+
+        loadNumber(kind, bits);
+
+        return kind;
+    }
+
+    std::int64_t TapeValue::asInt64() const {
+        NumberKind kind;
+        std::uint64_t bits;
+
+        loadNumber(kind, bits);
+
+        if (kind == NumberKind::j_int64 || (kind == NumberKind::j_uint64 && bits <= static_cast<std::uint64_t>(INT64_MAX)))
+            return static_cast<std::int64_t>(bits);
+
+        throw std::runtime_error {"Tape number is not an exact int64"};
+    }
+
+    std::uint64_t TapeValue::asUInt64() const {
+        NumberKind kind;
+        std::uint64_t bits;
+
+        loadNumber(kind, bits);
+
+        if (kind == NumberKind::j_uint64 || (kind == NumberKind::j_int64 && static_cast<std::int64_t>(bits) >= 0))
+            return bits;
+
+        throw std::runtime_error {"Tape number is not an exact uint64"};
+    }
+
+    std::string_view TapeValue::asString() const {
+        if (getType() != JsonType::j_string)
+            throw std::runtime_error {"Tape value is not a string"};
+
+        return state->viewString(index);
+    }
+
+    bool TapeValue::isEmpty() const {
+        return getNode().length == 0;
+    }
+
+    size_t TapeValue::getLength() const {
+        if (getType() != JsonType::j_array)
+            throw std::runtime_error {"Tape value is not an array"};
+
+        return getNode().length;
+    }
+
+    size_t TapeValue::getPropertyCount() const {
+        if (getType() != JsonType::j_object)
+            throw std::runtime_error {"Tape value is not an object"};
+
+        return getNode().length;
+    }
+
+    TapeValue TapeValue::getItemPtr(size_t pos) const {
+        if (pos >= getLength())
+            throw std::out_of_range {"Tape array index out of range"};
+
+        std::uint32_t cursor = index + 1;
+
+        for (size_t skipped = 0; skipped < pos; skipped++)
+            cursor = state->getNextIndex(cursor);
+
+        return {state, cursor};
+    }
+
+    bool TapeValue::hasProperty(std::string_view key) const {
+        return findProperty(key) != 0;
+    }
+
+    TapeValue TapeValue::getValuePtr(std::string_view key) const {
+        std::uint32_t found = findProperty(key);
+
+        if (found == 0)
+            throw std::out_of_range {"Tape object has no such property"};
+
+        return {state, found};
+    }
+
+    TapeValue TapeValue::getFirstChild() const {
+        return {state, index + 1};
+    }
+
+    TapeValue TapeValue::getNextSibling() const {
+        return {state, state->getNextIndex(index)};
+    }
+
+    const TapeNode& TapeValue::getNode() const {
+        return state->getNodeAt(index);
+    }
+
+    /// @note Returns the tape index of the last matching value, like a tree under DuplicateKeyPolicy::keep_last, or 0 since the root can never be a member.
+    std::uint32_t TapeValue::findProperty(std::string_view key) const {
+        size_t count = getPropertyCount();
+        std::uint32_t cursor = index + 1;
+        std::uint32_t found = 0;
+
+        for (size_t member = 0; member < count; member++) {
+            if (state->viewString(cursor) == key)
+                found = cursor + 1;
+
+            cursor = state->getNextIndex(cursor + 1);
+        }
+
+        return found;
+    }
+
+    /// @note Lazy numbers are converted on every access. The conversion is allocation-free and cheap next to a cache lookup.
+    void TapeValue::loadNumber(NumberKind& kind, std::uint64_t& bits) const {
+        if (getType() != JsonType::j_number)
+            throw std::runtime_error {"Tape value is not a number"};
+
+        const auto& node = getNode();
+
+        if ((node.flags & tape_lazy_bit) == 0) {
+            kind = static_cast<NumberKind>(node.flags & tape_kind_mask);
+            bits = node.payload;
+            return;
+        }
+
+        if (!state->codec->convert_number(state->viewRaw(node), kind, bits))
+            throw std::runtime_error {"Lazy tape number is malformed"};
+    }
+
+    /* JsonTape */
+
+    JsonTape::JsonTape()
+        : state {} {}
+
+    JsonTape::JsonTape(std::vector<TapeNode> x_nodes, std::string x_strings)
+        : state {std::make_shared<const TapeState>(std::move(x_nodes), std::move(x_strings), std::string_view {}, nullptr)} {}
+
+    JsonTape::JsonTape(std::vector<TapeNode> x_nodes, std::string x_strings, std::string_view x_source, const ScalarCodec* x_codec)
+        : state {std::make_shared<const TapeState>(std::move(x_nodes), std::move(x_strings), x_source, x_codec)} {}
+
+    JsonTape::JsonTape(std::span<const TapeNode> x_mapped_nodes, std::string_view x_mapped_strings)
+        : state {std::make_shared<const TapeState>(x_mapped_nodes, x_mapped_strings)} {}
+
+    bool JsonTape::isEmpty() const {
+        return getNodes().empty();
+    }
+
+    size_t JsonTape::getNodeCount() const {
+        return getNodes().size();
+    }
+
+    bool JsonTape::isLazy() const {
+        return state != nullptr && state->codec != nullptr;
+    }
+
+    std::span<const TapeNode> JsonTape::getNodes() const {
+        if (state == nullptr)
+            return {};
+
+        return state->getNodes();
+    }
+
+    std::string_view JsonTape::getStringPool() const {
+        if (state == nullptr)
+            return {};
+
+        return state->getStringPool();
+    }
+
+    TapeValue JsonTape::getRoot() const {
+        if (isEmpty())
+            throw std::runtime_error {"Tape is empty"};
+
+        return {state.get(), 0};
+    }
+
+    /* TapeBuilder */
+
+    TapeBuilder::TapeBuilder()
+        : nodes {}, strings {}, open_stack {} {}
+
+    void TapeBuilder::pushNull() {
+        countChild();
+        nodes.push_back({.type = JsonType::j_null, .flags = 0, .length = 0, .payload = 0});
+    }
+
+    void TapeBuilder::pushBoolean(bool flag) {
+        countChild();
+        nodes.push_back({.type = JsonType::j_boolean, .flags = 0, .length = 0, .payload = flag});
+    }
+
+    void TapeBuilder::pushNumber(double num) {
+        pushNumberBits(NumberKind::j_double, std::bit_cast<std::uint64_t>(num));
+    }
+
+    void TapeBuilder::pushNumber(std::int64_t num) {
+        pushNumberBits(NumberKind::j_int64, static_cast<std::uint64_t>(num));
+    }
+
+    void TapeBuilder::pushNumber(std::uint64_t num) {
+        pushNumberBits(NumberKind::j_uint64, num);
+    }
+
+    void TapeBuilder::pushString(std::string_view str) {
+        countChild();
+
+        size_t offset = strings.length();
+        strings.append(str);
+
+        nodes.push_back({.type = JsonType::j_string, .flags = 0, .length = static_cast<std::uint32_t>(str.length()), .payload = offset});
+    }
+
+    void TapeBuilder::pushKey(std::string_view key) {
+        countMember();
+
+        size_t offset = strings.length();
+        strings.append(key);
+
+        nodes.push_back({.type = JsonType::j_string, .flags = 0, .length = static_cast<std::uint32_t>(key.length()), .payload = offset});
+    }
+
+    void TapeBuilder::pushLazyNumber(size_t offset, size_t length) {
+        countChild();
+        nodes.push_back({.type = JsonType::j_number, .flags = tape_lazy_bit, .length = static_cast<std::uint32_t>(length), .payload = offset});
+    }
+
+    void TapeBuilder::pushLazyString(size_t offset, size_t length, bool escaped) {
+        std::uint8_t flags = escaped ? (tape_lazy_bit | tape_escaped_bit) : tape_lazy_bit;
+
+        countChild();
+        nodes.push_back({.type = JsonType::j_string, .flags = flags, .length = static_cast<std::uint32_t>(length), .payload = offset});
+    }
+
+    /// @note Only escape-free keys may be lazy: key comparisons read the raw span directly.
+    void TapeBuilder::pushLazyKey(size_t offset, size_t length) {
+        countMember();
+        nodes.push_back({.type = JsonType::j_string, .flags = tape_lazy_bit, .length = static_cast<std::uint32_t>(length), .payload = offset});
+    }
+
+    void TapeBuilder::beginArray() {
+        pushContainer(JsonType::j_array);
+    }
+
+    void TapeBuilder::endArray() {
+        closeContainer();
+    }
+
+    void TapeBuilder::beginObject() {
+        pushContainer(JsonType::j_object);
+    }
+
+    void TapeBuilder::endObject() {
+        closeContainer();
+    }
+
+    JsonTape TapeBuilder::release() {
+        open_stack.clear();
+
+        return JsonTape {std::move(nodes), std::move(strings)};
+    }
+
+    JsonTape TapeBuilder::release(std::string_view source, const ScalarCodec* codec) {
+        open_stack.clear();
+
+        return JsonTape {std::move(nodes), std::move(strings), source, codec};
+    }
+
+    void TapeBuilder::pushNumberBits(NumberKind kind, std::uint64_t bits) {
+        countChild();
+        nodes.push_back({.type = JsonType::j_number, .flags = static_cast<std::uint8_t>(kind), .length = 0, .payload = bits});
+    }
+
+    void TapeBuilder::pushContainer(JsonType type) {
+        countChild();
+        open_stack.push_back(static_cast<std::uint32_t>(nodes.size()));
+        nodes.push_back({.type = type, .flags = 0, .length = 0, .payload = 0});
+    }
+
+    void TapeBuilder::closeContainer() {
+        nodes[open_stack.back()].payload = nodes.size();
+        open_stack.pop_back();
+    }
+
+    /// @note Object members are counted once by their key, so only array items are counted here.
+    void TapeBuilder::countChild() {
+        if (open_stack.empty())
+            return;
+
+        auto& parent = nodes[open_stack.back()];
+
+        if (parent.type == JsonType::j_array)
+            parent.length++;
+    }
+
+    void TapeBuilder::countMember() {
+        nodes[open_stack.back()].length++;
+    }
+}
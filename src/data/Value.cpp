@@ -9,6 +9,7 @@
  */
 
 #include <exception>
+#include <iterator>
 #include <stdexcept>
 #include <utility>
 #include "data/IValue.hpp"
@@ -38,20 +39,73 @@ namespace toyjson::data {
         return std::any {value};
     }
 
+    bool BooleanField::asBoolean() const {
+        return value;
+    }
+
+    /* NumberField */
+
     NumberField::NumberField(double num)
-        : value {num} {}
+        : value {.real = num}, kind {NumberKind::j_double} {}
+
+    NumberField::NumberField(int num)
+        : NumberField(static_cast<std::int64_t>(num)) {}
+
+    NumberField::NumberField(std::int64_t num)
+        : value {.signed_whole = num}, kind {NumberKind::j_int64} {}
+
+    NumberField::NumberField(std::uint64_t num)
+        : value {.unsigned_whole = num}, kind {NumberKind::j_uint64} {}
 
     JsonType NumberField::getType() const {
         return JsonType::j_number;
     }
 
     std::any NumberField::toBoxedValue() const {
-        return std::any {value};
+        return std::any {asDouble()};
+    }
+
+    NumberKind NumberField::getNumberKind() const {
+        return kind;
+    }
+
+    bool NumberField::isIntegral() const {
+        return kind != NumberKind::j_double;
+    }
+
+    double NumberField::asDouble() const {
+        if (kind == NumberKind::j_int64)
+            return static_cast<double>(value.signed_whole);
+        else if (kind == NumberKind::j_uint64)
+            return static_cast<double>(value.unsigned_whole);
+
+        return value.real;
+    }
+
+    std::int64_t NumberField::asInt64() const {
+        if (kind == NumberKind::j_int64)
+            return value.signed_whole;
+        else if (kind == NumberKind::j_uint64 && value.unsigned_whole <= static_cast<std::uint64_t>(INT64_MAX))
+            return static_cast<std::int64_t>(value.unsigned_whole);
+
+        throw std::runtime_error {"Number is not an exact int64"};
+    }
+
+    std::uint64_t NumberField::asUInt64() const {
+        if (kind == NumberKind::j_uint64)
+            return value.unsigned_whole;
+        else if (kind == NumberKind::j_int64 && value.signed_whole >= 0)
+            return static_cast<std::uint64_t>(value.signed_whole);
+
+        throw std::runtime_error {"Number is not an exact uint64"};
     }
 
     /* StringField */
 
     StringField::StringField(std::string x_str)
+        : value {x_str} {}
+
+    StringField::StringField(std::pmr::string x_str)
         : value(std::move(x_str)) {}
 
     JsonType StringField::getType() const {
@@ -59,13 +113,20 @@ namespace toyjson::data {
     }
 
     std::any StringField::toBoxedValue() const {
-        return std::any {value};
+        return std::any {std::string {value}};
+    }
+
+    std::string_view StringField::asString() const {
+        return value;
     }
 
     ArrayField::ArrayField()
         : value {} {}
 
     ArrayField::ArrayField(std::vector<std::shared_ptr<IJsonValue>> x_items)
+        : value(std::make_move_iterator(x_items.begin()), std::make_move_iterator(x_items.end())) {}
+
+    ArrayField::ArrayField(ItemList x_items)
         : value(std::move(x_items)) {}
 
     JsonType ArrayField::getType() const {
@@ -73,7 +134,7 @@ namespace toyjson::data {
     }
 
     std::any ArrayField::toBoxedValue() const {
-        throw std::runtime_error {"Not implemented"};
+        return std::any {this};
     }
 
     bool ArrayField::isEmpty() const {
@@ -88,36 +149,90 @@ namespace toyjson::data {
         return value.at(pos);
     }
 
+    const IJsonValue& ArrayField::at(size_t pos) const {
+        return *value.at(pos);
+    }
+
+    ArrayField::Iterator ArrayField::begin() const {
+        return Iterator {value.cbegin()};
+    }
+
+    ArrayField::Iterator ArrayField::end() const {
+        return Iterator {value.cend()};
+    }
+
     /* ObjectField */
 
     ObjectField::ObjectField()
         : value {} {}
 
     ObjectField::ObjectField(std::map<std::string, std::shared_ptr<IJsonValue>> x_map)
-        : value(std::move(x_map)) {}
+        : value {} {
+        value.reserve(x_map.size());
+
+        for (auto& [key, item] : x_map)
+            value.insert(std::string_view {key}, std::move(item), DuplicateKeyPolicy::keep_last);
+    }
+
+    ObjectField::ObjectField(PropertyTable x_table)
+        : value(std::move(x_table)) {}
 
     JsonType ObjectField::getType() const {
         return JsonType::j_object;
     }
 
     std::any ObjectField::toBoxedValue() const {
-        throw std::runtime_error {"Not implemented"};
+        return std::any {this};
     }
 
     bool ObjectField::isEmpty() const {
-        return value.empty();
+        return value.isEmpty();
     }
 
     size_t ObjectField::getPropertyCount() const {
-        return value.size();
+        return value.getSize();
+    }
+
+    bool ObjectField::hasProperty(std::string_view key) const {
+        return value.find(key) != nullptr;
+    }
+
+    const std::shared_ptr<IJsonValue>& ObjectField::getValuePtr(std::string_view key) const {
+        const Property* entry = value.find(key);
+
+        if (entry == nullptr)
+            throw std::out_of_range {"Object has no such property"};
+
+        return entry->value;
+    }
+
+    bool ObjectField::hasProperty(Key key) const {
+        return value.find(key) != nullptr;
+    }
+
+    const std::shared_ptr<IJsonValue>& ObjectField::getValuePtr(Key key) const {
+        const Property* entry = value.find(key);
+
+        if (entry == nullptr)
+            throw std::out_of_range {"Object has no such property"};
+
+        return entry->value;
     }
 
-    bool ObjectField::hasProperty(const std::string& key) const {
-        return value.find(key) != value.end();
+    const PropertyTable& ObjectField::getProperties() const {
+        return value;
     }
 
-    const std::shared_ptr<IJsonValue>& ObjectField::getValuePtr(const std::string& key) const {
-        return value.at(key);
+    const IJsonValue& ObjectField::at(std::string_view key) const {
+        return *getValuePtr(key);
+    }
+
+    PropertyTable::const_iterator ObjectField::begin() const {
+        return value.begin();
+    }
+
+    PropertyTable::const_iterator ObjectField::end() const {
+        return value.end();
     }
 
     /* AnyField */
@@ -149,16 +264,44 @@ namespace toyjson::data {
         return std::any {*this};
     }
 
+    JsonType AnyField::getValueType() const
+    {
+        return std::visit([](const auto& inner) { return inner.getType(); }, value);
+    }
+
     /* ToyJsonDocument */
 
+    ToyJsonDocument::ToyJsonDocument()
+        : title {}, source_ptr {}, tape {}, mode {StorageMode::tree}, arena_ptr {}, root_ptr {} {}
+
     ToyJsonDocument::ToyJsonDocument(const std::string& name_str, std::shared_ptr<IJsonValue> x_root_ptr)
-        : title {name_str}, root_ptr(std::move(x_root_ptr)) {}
+        : title {name_str}, source_ptr {}, tape {}, mode {StorageMode::tree}, arena_ptr {}, root_ptr(std::move(x_root_ptr)) {}
+
+    ToyJsonDocument::ToyJsonDocument(const std::string& name_str, std::shared_ptr<IJsonValue> x_root_ptr, std::shared_ptr<std::pmr::memory_resource> x_arena_ptr)
+        : title {name_str}, source_ptr {}, tape {}, mode {StorageMode::tree}, arena_ptr(std::move(x_arena_ptr)), root_ptr(std::move(x_root_ptr)) {}
+
+    ToyJsonDocument::ToyJsonDocument(const std::string& name_str, std::shared_ptr<IJsonValue> x_root_ptr, std::shared_ptr<std::pmr::memory_resource> x_arena_ptr, std::shared_ptr<const void> x_keys_ptr)
+        : title {name_str}, source_ptr(std::move(x_keys_ptr)), tape {}, mode {StorageMode::tree}, arena_ptr(std::move(x_arena_ptr)), root_ptr(std::move(x_root_ptr)) {}
+
+    ToyJsonDocument::ToyJsonDocument(const std::string& name_str, JsonTape x_tape)
+        : title {name_str}, tape(std::move(x_tape)), mode {StorageMode::tape}, arena_ptr {}, root_ptr {} {}
+
+    ToyJsonDocument::ToyJsonDocument(const std::string& name_str, JsonTape x_tape, std::shared_ptr<const void> x_source_ptr)
+        : title {name_str}, source_ptr(std::move(x_source_ptr)), tape(std::move(x_tape)), mode {StorageMode::tape}, arena_ptr {}, root_ptr {} {}
 
     std::string_view ToyJsonDocument::getTitle() const {
         return title;
     }
 
+    StorageMode ToyJsonDocument::getStorageMode() const {
+        return mode;
+    }
+
     const std::shared_ptr<IJsonValue>& ToyJsonDocument::getRoot() const {
         return root_ptr;
     }
+
+    const JsonTape& ToyJsonDocument::getTape() const {
+        return tape;
+    }
 }
\ No newline at end of file
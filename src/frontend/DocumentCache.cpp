@@ -0,0 +1,252 @@
+/**
+ * @file DocumentCache.cpp
+ * @author DrkWithT
+ * @brief Implements the shared parsed document cache.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <sys/stat.h>
+#include "utils/Arena.hpp"
+#include "utils/InputSource.hpp"
+#include "frontend/DocumentCache.hpp"
+#include "frontend/Parser.hpp"
+
+namespace toyjson::frontend {
+    namespace {
+        struct FileIdentity {
+            std::uint64_t device;
+            std::uint64_t inode;
+            std::uint64_t bytes;
+            std::int64_t mtime_ns;
+
+            [[nodiscard]] bool operator==(const FileIdentity& other) const = default;
+        };
+
+        [[nodiscard]] FileIdentity identifyFile(const std::string& file_path_str) {
+            struct stat info {};
+
+            if (::stat(file_path_str.c_str(), &info) != 0)
+                throw std::system_error {errno, std::generic_category(), "Cannot stat " + file_path_str};
+
+            return FileIdentity {
+                .device = static_cast<std::uint64_t>(info.st_dev),
+                .inode = static_cast<std::uint64_t>(info.st_ino),
+                .bytes = static_cast<std::uint64_t>(info.st_size),
+                .mtime_ns = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1'000'000'000 + info.st_mtim.tv_nsec
+            };
+        }
+
+        [[nodiscard]] size_t hashContents(std::string_view text) {
+            return std::hash<std::string_view> {}(text);
+        }
+
+        [[nodiscard]] size_t hashFile(const std::string& file_path_str) {
+            auto source = utils::InputSource::open(file_path_str);
+
+            return hashContents(source->getText());
+        }
+    }
+
+    /// @note content_hash and charge are written before the future is fulfilled, so readers that waited on it see them. charged is guarded by writer_guard.
+    struct DocumentCache::Entry {
+        FileIdentity identity;
+        std::shared_future<DocPtr> doc;
+        std::atomic<std::uint64_t> last_use;
+        size_t content_hash;
+        size_t charge;
+        size_t charged;
+    };
+
+    DocumentCache::DocumentCache(DocumentCacheOptions x_options)
+        : table {std::make_shared<const EntryTable>()}, writer_guard {}, options {x_options}, clock {0}, hits {0}, misses {0}, coalesced {0}, evictions {0}, bytes {0} {}
+
+    DocumentCache::DocPtr DocumentCache::get(const std::string& file_path_str) {
+        auto identity = identifyFile(file_path_str);
+        std::shared_ptr<Entry> stale {};
+
+        // Fast path: no mutex, just the published table.
+        auto current = table.load(std::memory_order_acquire);
+
+        if (auto found = current->find(file_path_str); found != current->end()) {
+            auto entry = found->second;
+
+            if (entry->identity == identity) {
+                bool ready = entry->doc.wait_for(std::chrono::seconds {0}) == std::future_status::ready;
+                const auto& doc = entry->doc.get();
+
+                if (!options.verify_contents || hashFile(file_path_str) == entry->content_hash) {
+                    entry->last_use.store(clock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+                    (ready ? hits : coalesced).fetch_add(1, std::memory_order_relaxed);
+
+                    return doc;
+                }
+            }
+
+            stale = std::move(entry);
+        }
+
+        std::shared_ptr<Entry> joined {};
+        std::shared_ptr<Entry> fresh {};
+        std::promise<DocPtr> promise {};
+
+        {
+            std::lock_guard lock {writer_guard};
+            auto latest = table.load(std::memory_order_acquire);
+            auto found = latest->find(file_path_str);
+
+            // Another caller may have started this parse since the fast path looked.
+            if (found != latest->end() && found->second != stale && found->second->identity == identity) {
+                joined = found->second;
+            } else {
+                fresh = std::make_shared<Entry>(identity, promise.get_future().share(), clock.fetch_add(1, std::memory_order_relaxed), 0, 0, 0);
+
+                auto next = std::make_shared<EntryTable>(*latest);
+                auto& slot = (*next)[file_path_str];
+
+                if (slot)
+                    bytes -= slot->charged;
+
+                slot = fresh;
+                table.store(std::move(next), std::memory_order_release);
+            }
+        }
+
+        if (joined) {
+            coalesced.fetch_add(1, std::memory_order_relaxed);
+            joined->last_use.store(clock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+
+            return joined->doc.get();
+        }
+
+        misses.fetch_add(1, std::memory_order_relaxed);
+
+        return parseEntry(file_path_str, fresh, promise);
+    }
+
+    void DocumentCache::invalidate(const std::string& file_path_str) {
+        std::lock_guard lock {writer_guard};
+        auto latest = table.load(std::memory_order_acquire);
+        auto found = latest->find(file_path_str);
+
+        if (found == latest->end())
+            return;
+
+        auto next = std::make_shared<EntryTable>(*latest);
+
+        bytes -= found->second->charged;
+        next->erase(file_path_str);
+        table.store(std::move(next), std::memory_order_release);
+    }
+
+    void DocumentCache::clear() {
+        std::lock_guard lock {writer_guard};
+
+        bytes = 0;
+        table.store(std::make_shared<const EntryTable>(), std::memory_order_release);
+    }
+
+    DocumentCacheStats DocumentCache::getStats() const {
+        std::lock_guard lock {writer_guard};
+
+        return DocumentCacheStats {
+            .hits = hits.load(std::memory_order_relaxed),
+            .misses = misses.load(std::memory_order_relaxed),
+            .coalesced = coalesced.load(std::memory_order_relaxed),
+            .evictions = evictions.load(std::memory_order_relaxed),
+            .entries = table.load(std::memory_order_acquire)->size(),
+            .bytes = bytes
+        };
+    }
+
+    DocumentCache::DocPtr DocumentCache::parseEntry(const std::string& file_path_str, const std::shared_ptr<Entry>& entry, std::promise<DocPtr>& promise) {
+        DocPtr doc {};
+
+        try {
+            auto source = utils::InputSource::open(file_path_str);
+            auto arena = std::make_shared<utils::Arena>();
+            Parser parser {source->getText()};
+
+            doc = std::make_shared<const data::ToyJsonDocument>(parser.parseToADT(file_path_str, arena));
+            entry->content_hash = options.verify_contents ? hashContents(source->getText()) : 0;
+            entry->charge = arena->getBytesReserved();
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+            dropEntry(file_path_str, entry);
+            throw;
+        }
+
+        promise.set_value(doc);
+        admitEntry(file_path_str, entry);
+
+        return doc;
+    }
+
+    /// @brief Charges a finished entry to the budget, unless it was replaced or dropped while parsing, then evicts down to the budget.
+    void DocumentCache::admitEntry(const std::string& file_path_str, const std::shared_ptr<Entry>& entry) {
+        std::lock_guard lock {writer_guard};
+        auto latest = table.load(std::memory_order_acquire);
+        auto found = latest->find(file_path_str);
+
+        if (found == latest->end() || found->second != entry)
+            return;
+
+        entry->charged = entry->charge;
+        bytes += entry->charged;
+
+        if (bytes <= options.byte_budget)
+            return;
+
+        auto next = std::make_shared<EntryTable>(*latest);
+
+        evictOver(*next);
+        table.store(std::move(next), std::memory_order_release);
+    }
+
+    void DocumentCache::dropEntry(const std::string& file_path_str, const std::shared_ptr<Entry>& entry) {
+        std::lock_guard lock {writer_guard};
+        auto latest = table.load(std::memory_order_acquire);
+        auto found = latest->find(file_path_str);
+
+        if (found == latest->end() || found->second != entry)
+            return;
+
+        auto next = std::make_shared<EntryTable>(*latest);
+
+        next->erase(file_path_str);
+        table.store(std::move(next), std::memory_order_release);
+    }
+
+    /// @note Pending entries are never charged, so they are never evicted either.
+    void DocumentCache::evictOver(EntryTable& next) {
+        while (bytes > options.byte_budget) {
+            auto victim = next.end();
+            std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+
+            for (auto candidate = next.begin(); candidate != next.end(); candidate++) {
+                std::uint64_t last_use = candidate->second->last_use.load(std::memory_order_relaxed);
+
+                if (candidate->second->charged != 0 && last_use < oldest) {
+                    victim = candidate;
+                    oldest = last_use;
+                }
+            }
+
+            if (victim == next.end())
+                return;
+
+            bytes -= victim->second->charged;
+            next.erase(victim);
+            evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,344 @@
+/**
+ * @file Handler.cpp
+ * @author DrkWithT
+ * @brief Implements the built-in parse event handlers.
+ * @date 2024-05-27
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include "frontend/Handler.hpp"
+#include "frontend/StringScan.hpp"
+
+namespace toyjson::frontend {
+    /* Usings */
+    using JsonNull = toyjson::data::NullField;
+    using JsonBoolean = toyjson::data::BooleanField;
+    using JsonNumber = toyjson::data::NumberField;
+    using JsonString = toyjson::data::StringField;
+    using JsonArray = toyjson::data::ArrayField;
+    using JsonObject = toyjson::data::ObjectField;
+    using JsonAny = toyjson::data::AnyField;
+
+    /* Lazy scalar hooks */
+
+    namespace {
+        bool decodeLazyString(std::string_view raw, std::string& out) {
+            return appendDecoded(raw, out);
+        }
+
+        bool convertLazyNumber(std::string_view lexeme, data::NumberKind& kind, std::uint64_t& bits) {
+            NumberLiteral literal;
+
+            if (!parseNumber(lexeme, literal))
+                return false;
+
+            kind = literal.kind;
+
+            if (kind == data::NumberKind::j_int64)
+                bits = static_cast<std::uint64_t>(literal.signed_whole);
+            else if (kind == data::NumberKind::j_uint64)
+                bits = literal.unsigned_whole;
+            else
+                bits = std::bit_cast<std::uint64_t>(literal.real);
+
+            return true;
+        }
+
+        const data::ScalarCodec lazy_codec {.decode_string = decodeLazyString, .convert_number = convertLazyNumber};
+    }
+
+    /* DomHandler */
+
+    DomHandler::DomHandler()
+        : DomHandler(nullptr, data::DuplicateKeyPolicy::keep_last, nullptr) {}
+
+    DomHandler::DomHandler(std::shared_ptr<utils::Arena> x_arena)
+        : DomHandler(std::move(x_arena), data::DuplicateKeyPolicy::keep_last) {}
+
+    DomHandler::DomHandler(std::shared_ptr<utils::Arena> x_arena, data::DuplicateKeyPolicy x_policy)
+        : DomHandler(std::move(x_arena), x_policy, nullptr) {}
+
+    DomHandler::DomHandler(std::shared_ptr<utils::Arena> x_arena, data::DuplicateKeyPolicy x_policy, std::shared_ptr<data::KeyTable> x_keys)
+        : frames {x_arena ? static_cast<std::pmr::memory_resource*>(x_arena.get()) : std::pmr::get_default_resource()}, root {}, arena {std::move(x_arena)}, keys {std::move(x_keys)}, key_cache {}, resource {frames.get_allocator().resource()}, policy {x_policy}, duplicate_key {false} {}
+
+    bool DomHandler::onNull() {
+        return attach(makeNode(JsonNull()));
+    }
+
+    bool DomHandler::onBool(bool flag) {
+        return attach(makeNode(JsonBoolean(flag)));
+    }
+
+    bool DomHandler::onNumber(const NumberLiteral& number) {
+        if (number.kind == data::NumberKind::j_int64)
+            return attach(makeNode(JsonNumber(number.signed_whole)));
+        else if (number.kind == data::NumberKind::j_uint64)
+            return attach(makeNode(JsonNumber(number.unsigned_whole)));
+
+        return attach(makeNode(JsonNumber(number.real)));
+    }
+
+    bool DomHandler::onString(std::string_view text) {
+        return attach(makeNode(JsonString(std::pmr::string {text, resource})));
+    }
+
+    bool DomHandler::onKey(std::string_view key) {
+        Frame& parent = frames.back();
+
+        parent.key = internKey(key);
+
+        if (policy == data::DuplicateKeyPolicy::reject && parent.members.find(parent.key) != nullptr) {
+            duplicate_key = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool DomHandler::onStartObject() {
+        openFrame(true);
+        return true;
+    }
+
+    bool DomHandler::onEndObject() {
+        Frame x_frame = std::move(frames.back());
+        frames.pop_back();
+
+        return attach(makeNode(JsonObject(std::move(x_frame.members))));
+    }
+
+    bool DomHandler::onStartArray() {
+        openFrame(false);
+        return true;
+    }
+
+    bool DomHandler::onEndArray() {
+        Frame x_frame = std::move(frames.back());
+        frames.pop_back();
+
+        return attach(makeNode(JsonArray(std::move(x_frame.items))));
+    }
+
+    data::ToyJsonDocument DomHandler::toDocument(const std::string& name) {
+        if (arena)
+            return data::ToyJsonDocument {name, std::move(root), std::move(arena), std::move(keys)};
+
+        return data::ToyJsonDocument {name, std::move(root)};
+    }
+
+    void DomHandler::beginBody(bool is_object) {
+        openFrame(is_object);
+    }
+
+    data::ItemList DomHandler::releaseItems() {
+        data::ItemList x_items = std::move(frames.back().items);
+        frames.pop_back();
+
+        return x_items;
+    }
+
+    data::PropertyTable DomHandler::releaseMembers() {
+        data::PropertyTable x_members = std::move(frames.back().members);
+        frames.pop_back();
+
+        return x_members;
+    }
+
+    bool DomHandler::hasDuplicateKey() const {
+        return duplicate_key;
+    }
+
+    std::shared_ptr<data::IJsonValue> DomHandler::makeNode(JsonAny x_node) {
+        if (!arena)
+            return std::make_shared<JsonAny>(std::move(x_node));
+
+        std::pmr::polymorphic_allocator<JsonAny> allocator {resource};
+        JsonAny* node_ptr = allocator.new_object<JsonAny>(std::move(x_node));
+
+        return std::shared_ptr<data::IJsonValue> {node_ptr, []([[maybe_unused]] data::IJsonValue* ptr) {}, allocator};
+    }
+
+    data::Key DomHandler::internKey(std::string_view key) {
+        size_t hash = data::KeyTable::hashKey(key);
+        data::Key& cached = key_cache[hash % key_cache_size];
+
+        if (cached == nullptr || cached->hash != hash || cached->text != key)
+            cached = keys->intern(key, hash);
+
+        return cached;
+    }
+
+    bool DomHandler::attach(std::shared_ptr<data::IJsonValue> x_node) {
+        if (frames.empty()) {
+            root = std::move(x_node);
+            return true;
+        }
+
+        Frame& parent = frames.back();
+
+        if (parent.is_object)
+            (void)parent.members.insert(parent.key, std::move(x_node), policy);
+        else
+            parent.items.emplace_back(std::move(x_node));
+
+        return true;
+    }
+
+    void DomHandler::openFrame(bool is_object) {
+        if (!is_object) {
+            frames.push_back(Frame {.items = data::ItemList {resource}, .members = data::PropertyTable {}, .key = nullptr, .is_object = false});
+            return;
+        }
+
+        // Documents without a shared table get their own. An arena one is just more arena memory, so nothing owns it.
+        if (!keys && arena)
+            keys = std::shared_ptr<data::KeyTable> {std::shared_ptr<void> {}, std::pmr::polymorphic_allocator<data::KeyTable> {resource}.new_object<data::KeyTable>(resource)};
+        else if (!keys)
+            keys = std::make_shared<data::KeyTable>();
+
+        // Arena objects are never destroyed, so they must not hold counted references. The document keeps a shared table alive instead.
+        std::shared_ptr<data::KeyTable> table_ref = arena ? std::shared_ptr<data::KeyTable> {std::shared_ptr<void> {}, keys.get()} : keys;
+
+        frames.push_back(Frame {.items = data::ItemList {resource}, .members = data::PropertyTable {std::move(table_ref), resource}, .key = nullptr, .is_object = true});
+    }
+
+    /* TapeHandler */
+
+    TapeHandler::TapeHandler()
+        : builder {} {}
+
+    bool TapeHandler::onNull() {
+        builder.pushNull();
+        return true;
+    }
+
+    bool TapeHandler::onBool(bool flag) {
+        builder.pushBoolean(flag);
+        return true;
+    }
+
+    bool TapeHandler::onNumber(const NumberLiteral& number) {
+        if (number.kind == data::NumberKind::j_int64)
+            builder.pushNumber(number.signed_whole);
+        else if (number.kind == data::NumberKind::j_uint64)
+            builder.pushNumber(number.unsigned_whole);
+        else
+            builder.pushNumber(number.real);
+
+        return true;
+    }
+
+    bool TapeHandler::onString(std::string_view text) {
+        builder.pushString(text);
+        return true;
+    }
+
+    bool TapeHandler::onKey(std::string_view key) {
+        builder.pushKey(key);
+        return true;
+    }
+
+    bool TapeHandler::onStartObject() {
+        builder.beginObject();
+        return true;
+    }
+
+    bool TapeHandler::onEndObject() {
+        builder.endObject();
+        return true;
+    }
+
+    bool TapeHandler::onStartArray() {
+        builder.beginArray();
+        return true;
+    }
+
+    bool TapeHandler::onEndArray() {
+        builder.endArray();
+        return true;
+    }
+
+    data::ToyJsonDocument TapeHandler::toDocument(const std::string& name) {
+        return data::ToyJsonDocument {name, builder.release()};
+    }
+
+    /* LazyTapeHandler */
+
+    LazyTapeHandler::LazyTapeHandler(std::string_view source_sv)
+        : builder {}, source {source_sv} {}
+
+    bool LazyTapeHandler::onNull() {
+        builder.pushNull();
+        return true;
+    }
+
+    bool LazyTapeHandler::onBool(bool flag) {
+        builder.pushBoolean(flag);
+        return true;
+    }
+
+    bool LazyTapeHandler::onNumber(const NumberLiteral& number) {
+        if (number.kind == data::NumberKind::j_int64)
+            builder.pushNumber(number.signed_whole);
+        else if (number.kind == data::NumberKind::j_uint64)
+            builder.pushNumber(number.unsigned_whole);
+        else
+            builder.pushNumber(number.real);
+
+        return true;
+    }
+
+    bool LazyTapeHandler::onString(std::string_view text) {
+        builder.pushString(text);
+        return true;
+    }
+
+    bool LazyTapeHandler::onKey(std::string_view key) {
+        builder.pushKey(key);
+        return true;
+    }
+
+    bool LazyTapeHandler::onRawNumber(size_t offset, size_t length) {
+        builder.pushLazyNumber(offset, length);
+        return true;
+    }
+
+    bool LazyTapeHandler::onRawString(size_t offset, size_t length, bool escaped) {
+        builder.pushLazyString(offset, length, escaped);
+        return true;
+    }
+
+    bool LazyTapeHandler::onRawKey(size_t offset, size_t length) {
+        builder.pushLazyKey(offset, length);
+        return true;
+    }
+
+    bool LazyTapeHandler::onStartObject() {
+        builder.beginObject();
+        return true;
+    }
+
+    bool LazyTapeHandler::onEndObject() {
+        builder.endObject();
+        return true;
+    }
+
+    bool LazyTapeHandler::onStartArray() {
+        builder.beginArray();
+        return true;
+    }
+
+    bool LazyTapeHandler::onEndArray() {
+        builder.endArray();
+        return true;
+    }
+
+    data::ToyJsonDocument LazyTapeHandler::toDocument(const std::string& name, std::shared_ptr<const void> source_owner) {
+        return data::ToyJsonDocument {name, builder.release(source, &lazy_codec), std::move(source_owner)};
+    }
+}
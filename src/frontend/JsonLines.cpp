@@ -0,0 +1,212 @@
+/**
+ * @file JsonLines.cpp
+ * @author DrkWithT
+ * @brief Implements parallel newline-delimited JSON parsing.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include "utils/InputSource.hpp"
+#include "frontend/JsonLines.hpp"
+#include "frontend/Lexer.hpp"
+
+namespace toyjson::frontend {
+    namespace {
+        constexpr size_t no_error_line = static_cast<size_t>(-1);
+
+        [[nodiscard]] bool isBlankLine(std::string_view line) {
+            return std::all_of(line.begin(), line.end(), isSpacing);
+        }
+
+        [[nodiscard]] std::string describeError(const ParseError& error) {
+            std::string msg {toErrorName(error.status)};
+
+            msg.append(" at position ").append(std::to_string(error.offset)).append(": ").append(error.message);
+
+            return msg;
+        }
+    }
+
+    JsonLinesParser::JsonLinesParser(JsonLinesOptions x_options)
+        : options {x_options}, pool {x_options.worker_count}, workers {}, turn_lock {}, turn_changed {}, error_msg {}, error_line {no_error_line}, next_turn {0}, record_count {0}, failed {false} {
+        workers.reserve(pool.getWorkerCount());
+
+        for (size_t worker_id = 0; worker_id < pool.getWorkerCount(); worker_id++) {
+            workers.push_back(WorkerState {.parser = Parser {""}, .arena = std::make_shared<utils::Arena>(), .pending = {}, .pending_lines = {}});
+            workers.back().parser.setKeyTable(options.key_table);
+        }
+    }
+
+    JsonLinesStats JsonLinesParser::parse(std::string_view text, const RecordSink& sink) {
+        auto start_time = std::chrono::steady_clock::now();
+        std::vector<Batch> batches;
+        size_t batch_begin = 0;
+        size_t first_line = 0;
+
+        // Cuts land just past a newline, so no record spans two batches.
+        while (batch_begin < text.length()) {
+            size_t batch_end = text.length();
+
+            if (text.length() - batch_begin > options.batch_bytes) {
+                size_t newline_pos = text.find('\n', batch_begin + options.batch_bytes);
+
+                if (newline_pos != std::string_view::npos)
+                    batch_end = newline_pos + 1;
+            }
+
+            batches.push_back(Batch {.begin = batch_begin, .end = batch_end, .first_line = first_line});
+
+            first_line += static_cast<size_t>(std::count(text.begin() + batch_begin, text.begin() + batch_end, '\n'));
+            batch_begin = batch_end;
+        }
+
+        error_msg.clear();
+        error_line = no_error_line;
+        next_turn = 0;
+        record_count = 0;
+        failed = false;
+
+        for (size_t batch_index = 0; batch_index < batches.size(); batch_index++) {
+            pool.submit([this, text, &batches, batch_index, &sink](size_t worker_id) {
+                runBatch(worker_id, text, batches[batch_index], batch_index, sink);
+            });
+        }
+
+        pool.waitIdle();
+
+        if (failed)
+            throw std::runtime_error {error_msg};
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+
+        return {.records = record_count.load(), .bytes = text.length(), .seconds = elapsed.count()};
+    }
+
+    JsonLinesStats JsonLinesParser::parseFile(const std::string& file_path_str, const RecordSink& sink, bool populate) {
+        auto source = utils::InputSource::open(file_path_str, populate);
+
+        return parse(source->getText(), sink);
+    }
+
+    size_t JsonLinesParser::getWorkerCount() const {
+        return pool.getWorkerCount();
+    }
+
+    /**
+     * @note In ordered mode a worker parses its whole batch first and then waits its turn to deliver. Batches starting after a failed line skip their turn, and the rest still deliver every record before it.
+     * @note Waiting cannot deadlock: a worker runs its own deque front to back and only steals from the back of another's once its own is empty, so a stolen batch was the newest submitted. The owner of the batch holding the turn is thus never waiting behind a later one.
+     */
+    void JsonLinesParser::runBatch(size_t worker_id, std::string_view text, const Batch& batch, size_t batch_index, const RecordSink& sink) {
+        auto& state = workers[worker_id];
+        bool ordered = options.order == DeliveryOrder::ordered;
+        size_t line_index = batch.first_line;
+        size_t pos = batch.begin;
+        size_t records = 0;
+
+        while (pos < batch.end) {
+            size_t line_end = std::min(text.find('\n', pos), batch.end);
+            std::string_view line = text.substr(pos, line_end - pos);
+            size_t current_line = line_index++;
+
+            if (current_line >= error_line.load(std::memory_order_relaxed))
+                break;
+
+            pos = line_end + 1;
+
+            if (isBlankLine(line))
+                continue;
+
+            state.parser.reset(line);
+
+            auto result = state.parser.tryParseToADT("", state.arena);
+
+            if (!result) {
+                recordError(current_line, describeError(result.getError()));
+                break;
+            } else if (state.parser.hasTrailingInput()) {
+                recordError(current_line, "Unexpected text after the record.");
+                break;
+            }
+
+            records++;
+
+            if (ordered) {
+                state.pending.push_back(std::move(*result));
+                state.pending_lines.push_back(current_line);
+                continue;
+            }
+
+            try {
+                sink(current_line, *result);
+            } catch (const std::exception& err) {
+                recordError(current_line, err.what());
+                break;
+            }
+        }
+
+        if (ordered) {
+            std::unique_lock guard {turn_lock};
+
+            turn_changed.wait(guard, [this, &batch, batch_index]() { return next_turn == batch_index || batch.first_line > error_line; });
+
+            bool has_turn = next_turn == batch_index;
+
+            guard.unlock();
+
+            // Only the batch holding the turn gets here, so the sink is never entered twice at once.
+            if (has_turn) {
+                for (size_t record = 0; record < state.pending.size() && state.pending_lines[record] < error_line; record++) {
+                    try {
+                        sink(state.pending_lines[record], state.pending[record]);
+                    } catch (const std::exception& err) {
+                        recordError(state.pending_lines[record], err.what());
+                    }
+                }
+
+                guard.lock();
+                next_turn++;
+                guard.unlock();
+
+                turn_changed.notify_all();
+            }
+        }
+
+        record_count += records;
+        recycleArena(state);
+    }
+
+    /// @note Keeps the error from the earliest line, since batches can fail out of order.
+    void JsonLinesParser::recordError(size_t line_index, std::string_view what) {
+        {
+            std::lock_guard guard {turn_lock};
+
+            if (!failed || line_index < error_line) {
+                error_line = line_index;
+                error_msg = "Line " + std::to_string(line_index + 1) + ": ";
+                error_msg.append(what);
+            }
+
+            failed = true;
+        }
+
+        turn_changed.notify_all();
+    }
+
+    void JsonLinesParser::recycleArena(WorkerState& state) {
+        state.pending.clear();
+        state.pending_lines.clear();
+
+        // A sink that kept a document also shares its arena, so that arena is handed off rather than reset.
+        if (state.arena.use_count() == 1)
+            state.arena->reset();
+        else
+            state.arena = std::make_shared<utils::Arena>();
+    }
+}
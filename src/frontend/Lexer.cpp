@@ -9,16 +9,19 @@
  */
 
 #include "frontend/Lexer.hpp"
+#include "frontend/StringScan.hpp"
 #include "frontend/Token.hpp"
 
 namespace toyjson::frontend {
     /* Lexer public impl */
 
     Lexer::Lexer(std::string_view sv_arg)
-    : kword_map{}, symbols {sv_arg}, limit {sv_arg.length()}, pos {0}, line {0} {
-        kword_map["null"] = TokenType::lt_null;
-        kword_map["true"] = TokenType::lt_true;
-        kword_map["false"] = TokenType::lt_false;
+    : symbols {sv_arg}, limit {sv_arg.length()}, pos {0} {}
+
+    void Lexer::reset(std::string_view sv_arg) {
+        symbols = sv_arg;
+        limit = sv_arg.length();
+        pos = 0;
     }
 
     Token Lexer::lexNext() {
@@ -48,7 +51,7 @@ namespace toyjson::frontend {
 
         if (isSpacing(peeked))
             return lexWhitespace(); 
-        else if (isNumeric(peeked))
+        else if (isNumberStart(peeked))
             return lexNumber();
         else if (isWordSymbol(peeked))
             return lexKeyword();
@@ -80,28 +83,16 @@ namespace toyjson::frontend {
         pos++;
 
         size_t begin = pos;
-        size_t length = 0;
-        char c;
-        bool closed = false; // has right-side delim
+        size_t end = (delim == '\"') ? findStringEnd(symbols, begin) : symbols.find(delim, begin);
 
-        while (!isAtEnd()) {
-            c = peekSymbol();
-
-            if (c == delim) {
-                closed = true;
-                pos++;
-                break;
-            }
-
-            length++;
-            pos++;
+        if (end == std::string_view::npos) {
+            pos = limit;
+            return {.begin = begin, .length = limit - begin, .type = TokenType::unknown};
         }
 
-        return {
-            .begin = begin,
-            .length = length,
-            .type = ((closed) ? type : TokenType::unknown)
-        };
+        pos = end + 1;
+
+        return {.begin = begin, .length = end - begin, .type = type};
     }
 
     Token Lexer::lexWhitespace() {
@@ -115,9 +106,6 @@ namespace toyjson::frontend {
             if (!isSpacing(c))
                 break;
 
-            if (c == '\n')
-                line++;
-
             length++;
             pos++;
         }
@@ -141,12 +129,8 @@ namespace toyjson::frontend {
         }
 
         Token result = {.begin = begin, .length = length, .type = TokenType::unknown};
-        auto lexeme = getLexeme(result, symbols);
-
-        if (kword_map.find(lexeme) == kword_map.end())
-            return result;
 
-        result.type = kword_map.at(lexeme);
+        result.type = lookupKeyword(viewLexeme(result, symbols));
 
         return result;
     }
@@ -154,7 +138,6 @@ namespace toyjson::frontend {
     Token Lexer::lexNumber() {
         size_t begin = pos;
         size_t length = 0;
-        int dots = 0;
         char c;
 
         while (!isAtEnd()) {
@@ -163,19 +146,12 @@ namespace toyjson::frontend {
             if (!isNumeric(c))
                 break;
 
-            if (c == '.')
-                dots++;
-
             length++;
             pos++;
         }
 
-        switch (dots) {
-            case 0:
-            case 1:
-                return {.begin = begin, .length = length, .type = TokenType::lt_number};
-            default:
-                return {.begin = begin, .length = length, .type = TokenType::unknown};
-        }
+        TokenType type = isJsonNumber(symbols.substr(begin, length)) ? TokenType::lt_number : TokenType::unknown;
+
+        return {.begin = begin, .length = length, .type = type};
     }
 }
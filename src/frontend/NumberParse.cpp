@@ -0,0 +1,134 @@
+/**
+ * @file NumberParse.cpp
+ * @author DrkWithT
+ * @brief Implements the number conversion kernel.
+ * @date 2024-05-24
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <system_error>
+#include "frontend/NumberParse.hpp"
+
+namespace toyjson::frontend {
+    namespace {
+        /// @brief Accumulates the digits of an integral literal. Returns false once the magnitude no longer fits in 64 bits.
+        [[nodiscard]] bool accumulateDigits(std::string_view digits, std::uint64_t& magnitude) {
+            constexpr std::uint64_t max_before_shift = std::numeric_limits<std::uint64_t>::max() / 10;
+
+            magnitude = 0;
+
+            for (char c : digits) {
+                auto digit = static_cast<std::uint64_t>(c - '0');
+
+                if (magnitude > max_before_shift || (magnitude == max_before_shift && digit > std::numeric_limits<std::uint64_t>::max() % 10))
+                    return false;
+
+                magnitude = magnitude * 10 + digit;
+            }
+
+            return true;
+        }
+
+        [[nodiscard]] bool isIntegralLexeme(std::string_view lexeme) {
+            return lexeme.find_first_of(".eE") == std::string_view::npos;
+        }
+
+        [[nodiscard]] bool tryExactInteger(std::string_view lexeme, NumberLiteral& result) {
+            bool negative = lexeme.front() == '-';
+            std::uint64_t magnitude = 0;
+
+            if (!accumulateDigits(lexeme.substr(negative ? 1 : 0), magnitude))
+                return false;
+
+            constexpr auto int64_max = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+
+            if (!negative) {
+                if (magnitude <= int64_max) {
+                    result.kind = data::NumberKind::j_int64;
+                    result.signed_whole = static_cast<std::int64_t>(magnitude);
+                } else {
+                    result.kind = data::NumberKind::j_uint64;
+                    result.unsigned_whole = magnitude;
+                }
+
+                return true;
+            }
+
+            // -0 is left to the double path, which keeps its sign.
+            if (magnitude == 0 || magnitude > int64_max + 1)
+                return false;
+
+            result.kind = data::NumberKind::j_int64;
+            result.signed_whole = (magnitude == int64_max + 1) ? std::numeric_limits<std::int64_t>::min() : -static_cast<std::int64_t>(magnitude);
+
+            return true;
+        }
+
+        /// @brief Tells overflow from underflow for a literal std::from_chars found out of range, by whether its leading nonzero mantissa digit sits above the units place once the exponent is applied.
+        [[nodiscard]] bool isAboveOne(std::string_view lexeme) {
+            constexpr std::int64_t exponent_cap = 1'000'000'000'000;
+
+            size_t pos = (lexeme.front() == '-') ? 1 : 0;
+            std::int64_t lead = 0; // the value is 0.ddd... times 10^(lead + exponent)
+            bool after_point = false;
+            bool seen_nonzero = false;
+
+            for (; pos < lexeme.length() && lexeme[pos] != 'e' && lexeme[pos] != 'E'; pos++) {
+                if (lexeme[pos] == '.') {
+                    after_point = true;
+                } else if (!seen_nonzero && lexeme[pos] == '0') {
+                    lead -= after_point ? 1 : 0;
+                } else {
+                    seen_nonzero = true;
+                    lead += after_point ? 0 : 1;
+                }
+            }
+
+            std::int64_t exponent = 0;
+            bool negative_exponent = false;
+
+            if (pos < lexeme.length()) {
+                pos++;
+
+                if (lexeme[pos] == '+' || lexeme[pos] == '-')
+                    negative_exponent = lexeme[pos++] == '-';
+
+                for (; pos < lexeme.length() && exponent < exponent_cap; pos++)
+                    exponent = exponent * 10 + (lexeme[pos] - '0');
+            }
+
+            return lead + (negative_exponent ? -exponent : exponent) > 0;
+        }
+    }
+
+    bool parseNumber(std::string_view lexeme, NumberLiteral& result) {
+        if (!isJsonNumber(lexeme))
+            return false;
+
+        result = {.kind = data::NumberKind::j_double, .signed_whole = 0, .unsigned_whole = 0, .real = 0.0};
+
+        if (isIntegralLexeme(lexeme) && tryExactInteger(lexeme, result))
+            return true;
+
+        result.kind = data::NumberKind::j_double;
+
+        auto [stop, error] = std::from_chars(lexeme.data(), lexeme.data() + lexeme.length(), result.real);
+
+        if (stop != lexeme.data() + lexeme.length())
+            return false;
+
+        if (error == std::errc::result_out_of_range) {
+            double magnitude = isAboveOne(lexeme) ? std::numeric_limits<double>::infinity() : 0.0;
+
+            result.real = (lexeme.front() == '-') ? -magnitude : magnitude;
+            return true;
+        }
+
+        return error == std::errc {};
+    }
+}
@@ -0,0 +1,476 @@
+/**
+ * @file OnDemand.cpp
+ * @author DrkWithT
+ * @brief Implements lazy navigation over raw JSON text.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <bit>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include "utils/InputSource.hpp"
+#include "frontend/Lexer.hpp"
+#include "frontend/NumberParse.hpp"
+#include "frontend/OnDemand.hpp"
+#include "frontend/ParseInfo.hpp"
+#include "frontend/StringScan.hpp"
+
+namespace toyjson::frontend {
+    /* Raw text skipping */
+
+    namespace {
+        constexpr size_t no_pos = std::string_view::npos;
+
+        [[noreturn]] void throwAt(size_t pos, ParseStatus status, std::string_view msg_sv) {
+            std::ostringstream sout {};
+
+            sout << toErrorName(status) << " at position " << pos << ": " << msg_sv;
+
+            throw std::runtime_error {sout.str()};
+        }
+
+        [[nodiscard]] size_t skipSpacing(std::string_view text, size_t pos) {
+            while (pos < text.length() && isSpacing(text[pos]))
+                pos++;
+
+            return pos;
+        }
+
+        /// @note pos is at the opening quote. Returns the position just past the closing one.
+        [[nodiscard]] size_t skipString(std::string_view text, size_t pos) {
+            size_t closing = findStringEnd(text, pos + 1);
+
+            if (closing == no_pos)
+                throwAt(pos, ParseStatus::err_unexpected_eof, "Unterminated string.\n");
+
+            return closing + 1;
+        }
+
+        [[nodiscard]] size_t skipLiteral(std::string_view text, size_t pos) {
+            while (pos < text.length() && (isNumeric(text[pos]) || isWordSymbol(text[pos])))
+                pos++;
+
+            return pos;
+        }
+
+        /// @note Only brackets and quotes are looked at, so a skipped subtree is never tokenized. Strings are jumped over with the vectorized scanner.
+        [[nodiscard]] size_t skipContainer(std::string_view text, size_t pos) {
+            size_t depth = 0;
+            size_t limit = text.length();
+
+            while (pos < limit) {
+                char c = text[pos];
+
+                if (c == '\"') {
+                    pos = skipString(text, pos);
+                    continue;
+                }
+
+                if (c == '[' || c == '{') {
+                    depth++;
+                } else if (c == ']' || c == '}') {
+                    depth--;
+
+                    if (depth == 0)
+                        return pos + 1;
+                }
+
+                pos++;
+            }
+
+            throwAt(pos, ParseStatus::err_unexpected_eof, "Unclosed container.\n");
+        }
+
+        [[nodiscard]] size_t skipValue(std::string_view text, size_t pos) {
+            if (pos >= text.length())
+                throwAt(pos, ParseStatus::err_unexpected_eof, "Expected a value.\n");
+
+            char c = text[pos];
+
+            if (c == '\"')
+                return skipString(text, pos);
+            else if (c == '[' || c == '{')
+                return skipContainer(text, pos);
+
+            size_t end = skipLiteral(text, pos);
+
+            if (end == pos)
+                throwAt(pos, ParseStatus::err_unknown_token, "Unexpected character for value.\n");
+
+            return end;
+        }
+
+        /// @brief Returns the position of the first element or member after an opener, or npos if the container is empty.
+        [[nodiscard]] size_t firstEntry(std::string_view text, size_t open_pos) {
+            char closer = (text[open_pos] == '{') ? '}' : ']';
+            size_t pos = skipSpacing(text, open_pos + 1);
+
+            if (pos >= text.length())
+                throwAt(pos, ParseStatus::err_unexpected_eof, "Unclosed container.\n");
+
+            if (text[pos] == closer)
+                return no_pos;
+
+            if (closer == '}' && text[pos] != '\"')
+                throwAt(pos, ParseStatus::err_misplaced_token, "Expected a property name.\n");
+
+            return pos;
+        }
+
+        /// @brief Returns the position of the value of the member whose key starts at key_pos.
+        [[nodiscard]] size_t memberValue(std::string_view text, size_t key_pos) {
+            size_t pos = skipSpacing(text, skipString(text, key_pos));
+
+            if (pos >= text.length() || text[pos] != ':')
+                throwAt(pos, ParseStatus::err_misplaced_token, "Expected ':' after property name.\n");
+
+            return skipSpacing(text, pos + 1);
+        }
+
+        /// @brief Steps past the value at value_pos to the next entry, or returns npos at the closer.
+        [[nodiscard]] size_t nextEntry(std::string_view text, size_t value_pos, char closer) {
+            size_t pos = skipSpacing(text, skipValue(text, value_pos));
+
+            if (pos >= text.length())
+                throwAt(pos, ParseStatus::err_unexpected_eof, "Unclosed container.\n");
+
+            if (text[pos] == closer)
+                return no_pos;
+
+            if (text[pos] != ',')
+                throwAt(pos, ParseStatus::err_misplaced_token, "Expected ',' or container end.\n");
+
+            pos = skipSpacing(text, pos + 1);
+
+            if (closer == '}' && (pos >= text.length() || text[pos] != '\"'))
+                throwAt(pos, ParseStatus::err_misplaced_token, "Expected a property name.\n");
+
+            return pos;
+        }
+
+        [[nodiscard]] std::string decodeRaw(std::string_view raw, size_t pos) {
+            std::string result;
+
+            if (!appendDecoded(raw, result))
+                throwAt(pos, ParseStatus::err_bad_escape, "Malformed escape in string.\n");
+
+            return result;
+        }
+    }
+
+    /* OnDemandValue */
+
+    OnDemandValue::OnDemandValue(std::string_view x_source, size_t x_begin)
+        : source {x_source}, begin_pos {x_begin} {}
+
+    data::JsonType OnDemandValue::getType() const {
+        if (begin_pos >= source.length())
+            throwAt(begin_pos, ParseStatus::err_unexpected_eof, "Expected a value.\n");
+
+        char c = source[begin_pos];
+
+        switch (c) {
+            case '{':
+                return data::JsonType::j_object;
+            case '[':
+                return data::JsonType::j_array;
+            case '\"':
+                return data::JsonType::j_string;
+            case 't':
+            case 'f':
+                return data::JsonType::j_boolean;
+            case 'n':
+                return data::JsonType::j_null;
+            default:
+                break;
+        }
+
+        if (isNumberStart(c))
+            return data::JsonType::j_number;
+
+        throwAt(begin_pos, ParseStatus::err_unknown_token, "Unexpected character for value.\n");
+    }
+
+    bool OnDemandValue::asBoolean() const {
+        TokenType type = lookupKeyword(getRawJson());
+
+        if (type != TokenType::lt_true && type != TokenType::lt_false)
+            throw std::runtime_error {"On-demand value is not a boolean"};
+
+        return type == TokenType::lt_true;
+    }
+
+    double OnDemandValue::asNumber() const {
+        data::NumberKind kind;
+        std::uint64_t bits;
+
+        loadNumber(kind, bits);
+
+        if (kind == data::NumberKind::j_int64)
+            return static_cast<double>(static_cast<std::int64_t>(bits));
+        else if (kind == data::NumberKind::j_uint64)
+            return static_cast<double>(bits);
+
+        return std::bit_cast<double>(bits);
+    }
+
+    data::NumberKind OnDemandValue::getNumberKind() const {
+        data::NumberKind kind;
+        std::uint64_t bits;
+
+        loadNumber(kind, bits);
+
+        return kind;
+    }
+
+    std::int64_t OnDemandValue::asInt64() const {
+        data::NumberKind kind;
+        std::uint64_t bits;
+
+        loadNumber(kind, bits);
+
+        if (kind == data::NumberKind::j_int64 || (kind == data::NumberKind::j_uint64 && bits <= static_cast<std::uint64_t>(INT64_MAX)))
+            return static_cast<std::int64_t>(bits);
+
+        throw std::runtime_error {"On-demand number is not an exact int64"};
+    }
+
+    std::uint64_t OnDemandValue::asUInt64() const {
+        data::NumberKind kind;
+        std::uint64_t bits;
+
+        loadNumber(kind, bits);
+
+        if (kind == data::NumberKind::j_uint64 || (kind == data::NumberKind::j_int64 && static_cast<std::int64_t>(bits) >= 0))
+            return bits;
+
+        throw std::runtime_error {"On-demand number is not an exact uint64"};
+    }
+
+    std::string OnDemandValue::asString() const {
+        return decodeRaw(asRawString(), begin_pos);
+    }
+
+    std::string_view OnDemandValue::asRawString() const {
+        expectType(data::JsonType::j_string, "On-demand value is not a string");
+
+        size_t end = skipString(source, begin_pos);
+
+        return source.substr(begin_pos + 1, end - begin_pos - 2);
+    }
+
+    std::string_view OnDemandValue::getRawJson() const {
+        return source.substr(begin_pos, skipValue(source, begin_pos) - begin_pos);
+    }
+
+    bool OnDemandValue::isEmpty() const {
+        data::JsonType type = getType();
+
+        if (type != data::JsonType::j_array && type != data::JsonType::j_object)
+            throw std::runtime_error {"On-demand value is not a container"};
+
+        return firstEntry(source, begin_pos) == no_pos;
+    }
+
+    size_t OnDemandValue::getLength() const {
+        size_t count = 0;
+
+        for (auto it = begin(); it != end(); ++it)
+            count++;
+
+        return count;
+    }
+
+    size_t OnDemandValue::getPropertyCount() const {
+        size_t count = 0;
+
+        for (auto it = beginProperties(); it != endProperties(); ++it)
+            count++;
+
+        return count;
+    }
+
+    OnDemandValue OnDemandValue::getItemPtr(size_t pos) const {
+        auto it = begin();
+
+        for (size_t skipped = 0; skipped < pos && it != end(); skipped++)
+            ++it;
+
+        if (it == end())
+            throw std::out_of_range {"On-demand array index out of range"};
+
+        return *it;
+    }
+
+    bool OnDemandValue::hasProperty(std::string_view key) const {
+        return findProperty(key) != no_pos;
+    }
+
+    OnDemandValue OnDemandValue::getValuePtr(std::string_view key) const {
+        size_t found = findProperty(key);
+
+        if (found == no_pos)
+            throw std::out_of_range {"On-demand object has no such property"};
+
+        return {source, found};
+    }
+
+    OnDemandItemIterator OnDemandValue::begin() const {
+        expectType(data::JsonType::j_array, "On-demand value is not an array");
+
+        size_t first = firstEntry(source, begin_pos);
+
+        return (first == no_pos) ? OnDemandItemIterator {} : OnDemandItemIterator {source, first};
+    }
+
+    OnDemandItemIterator OnDemandValue::end() const {
+        return {};
+    }
+
+    OnDemandPropertyIterator OnDemandValue::beginProperties() const {
+        expectType(data::JsonType::j_object, "On-demand value is not an object");
+
+        size_t first = firstEntry(source, begin_pos);
+
+        return (first == no_pos) ? OnDemandPropertyIterator {} : OnDemandPropertyIterator {source, first};
+    }
+
+    OnDemandPropertyIterator OnDemandValue::endProperties() const {
+        return {};
+    }
+
+    void OnDemandValue::expectType(data::JsonType type, const char* msg) const {
+        if (getType() != type)
+            throw std::runtime_error {msg};
+    }
+
+    void OnDemandValue::loadNumber(data::NumberKind& kind, std::uint64_t& bits) const {
+        expectType(data::JsonType::j_number, "On-demand value is not a number");
+
+        NumberLiteral literal;
+
+        if (!parseNumber(source.substr(begin_pos, skipLiteral(source, begin_pos) - begin_pos), literal))
+            throwAt(begin_pos, ParseStatus::err_bad_number, "Malformed number.\n");
+
+        kind = literal.kind;
+
+        if (kind == data::NumberKind::j_int64)
+            bits = static_cast<std::uint64_t>(literal.signed_whole);
+        else if (kind == data::NumberKind::j_uint64)
+            bits = literal.unsigned_whole;
+        else
+            bits = std::bit_cast<std::uint64_t>(literal.real);
+    }
+
+    /// @note Keys are compared raw first. Only keys holding escapes are decoded to compare. Returns the first match, so the rest of the object is never skipped over.
+    size_t OnDemandValue::findProperty(std::string_view key) const {
+        expectType(data::JsonType::j_object, "On-demand value is not an object");
+
+        size_t key_pos = firstEntry(source, begin_pos);
+
+        while (key_pos != no_pos) {
+            size_t key_end = skipString(source, key_pos);
+            std::string_view raw_key = source.substr(key_pos + 1, key_end - key_pos - 2);
+            size_t value_pos = memberValue(source, key_pos);
+
+            if (raw_key == key)
+                return value_pos;
+
+            if (findBackslash(raw_key, 0) != no_pos && decodeRaw(raw_key, key_pos) == key)
+                return value_pos;
+
+            key_pos = nextEntry(source, value_pos, '}');
+        }
+
+        return no_pos;
+    }
+
+    /* OnDemandMember */
+
+    std::string OnDemandMember::getKey() const {
+        return decodeRaw(raw_key, 0);
+    }
+
+    /* OnDemandItemIterator */
+
+    OnDemandItemIterator::OnDemandItemIterator()
+        : source {}, pos {no_pos} {}
+
+    OnDemandItemIterator::OnDemandItemIterator(std::string_view x_source, size_t x_pos)
+        : source {x_source}, pos {x_pos} {}
+
+    OnDemandValue OnDemandItemIterator::operator*() const {
+        return {source, pos};
+    }
+
+    OnDemandItemIterator& OnDemandItemIterator::operator++() {
+        pos = nextEntry(source, pos, ']');
+        return *this;
+    }
+
+    OnDemandItemIterator OnDemandItemIterator::operator++(int) {
+        OnDemandItemIterator old = *this;
+        ++(*this);
+        return old;
+    }
+
+    bool OnDemandItemIterator::operator==(const OnDemandItemIterator& other) const {
+        return pos == other.pos;
+    }
+
+    /* OnDemandPropertyIterator */
+
+    OnDemandPropertyIterator::OnDemandPropertyIterator()
+        : source {}, pos {no_pos} {}
+
+    OnDemandPropertyIterator::OnDemandPropertyIterator(std::string_view x_source, size_t x_pos)
+        : source {x_source}, pos {x_pos} {}
+
+    OnDemandMember OnDemandPropertyIterator::operator*() const {
+        size_t key_end = skipString(source, pos);
+
+        return {.raw_key = source.substr(pos + 1, key_end - pos - 2), .value = OnDemandValue {source, memberValue(source, pos)}};
+    }
+
+    OnDemandPropertyIterator& OnDemandPropertyIterator::operator++() {
+        pos = nextEntry(source, memberValue(source, pos), '}');
+        return *this;
+    }
+
+    OnDemandPropertyIterator OnDemandPropertyIterator::operator++(int) {
+        OnDemandPropertyIterator old = *this;
+        ++(*this);
+        return old;
+    }
+
+    bool OnDemandPropertyIterator::operator==(const OnDemandPropertyIterator& other) const {
+        return pos == other.pos;
+    }
+
+    /* OnDemandDocument */
+
+    OnDemandDocument::OnDemandDocument(const std::string& name_str, std::string_view x_source)
+        : title {name_str}, source_ptr {}, source {x_source} {}
+
+    OnDemandDocument::OnDemandDocument(const std::string& name_str, std::string_view x_source, std::shared_ptr<const void> x_source_ptr)
+        : title {name_str}, source_ptr {std::move(x_source_ptr)}, source {x_source} {}
+
+    OnDemandDocument OnDemandDocument::openFile(const std::string& file_path_str, bool populate) {
+        auto x_source = utils::InputSource::open(file_path_str, populate);
+        auto text = x_source->getText();
+
+        return {file_path_str, text, std::move(x_source)};
+    }
+
+    const std::string& OnDemandDocument::getTitle() const {
+        return title;
+    }
+
+    OnDemandValue OnDemandDocument::getRoot() const {
+        return {source, skipSpacing(source, 0)};
+    }
+}
@@ -0,0 +1,192 @@
+/**
+ * @file ParallelParse.cpp
+ * @author DrkWithT
+ * @brief Implements parallel parsing of one large top-level container.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include "frontend/Handler.hpp"
+#include "frontend/Lexer.hpp"
+#include "frontend/ParallelParse.hpp"
+#include "frontend/Parser.hpp"
+#include "frontend/StructuralIndex.hpp"
+
+namespace toyjson::frontend {
+    namespace {
+        /// @note Bounds the pre-scan's index memory. Windows only grow past this for a single string longer than the window.
+        constexpr size_t scan_window_size = 64 * 1024 * 1024;
+    }
+
+    ParallelParser::ParallelParser(ParallelOptions x_options)
+        : options {x_options}, pool {x_options.worker_count} {}
+
+    data::ToyJsonDocument ParallelParser::parse(const std::string& name, std::string_view json_sv) {
+        std::shared_ptr<data::KeyTable> keys = options.key_table;
+        size_t root_pos = 0;
+
+        while (root_pos < json_sv.length() && isSpacing(json_sv[root_pos]))
+            root_pos++;
+
+        if (json_sv.length() < options.min_parallel_bytes || root_pos >= json_sv.length() || (json_sv[root_pos] != '[' && json_sv[root_pos] != '{')) {
+            return parseSequential(name, json_sv, keys);
+        }
+
+        size_t chunk_count = std::max<size_t>(1, pool.getWorkerCount() * options.chunks_per_worker);
+        std::vector<size_t> splits;
+        size_t root_end = 0;
+
+        if (!findSplits(json_sv, root_pos, json_sv.length() / chunk_count, splits, root_end) || splits.empty()) {
+            return parseSequential(name, json_sv, keys);
+        }
+
+        bool is_object = json_sv[root_pos] == '{';
+        std::vector<Chunk> chunks;
+        size_t chunk_begin = root_pos + 1;
+
+        splits.push_back(root_end);
+
+        for (size_t split_pos : splits) {
+            chunks.push_back(Chunk {.begin = chunk_begin, .end = split_pos, .items = {}, .members = {}, .failed = false});
+            chunk_begin = split_pos + 1;
+        }
+
+        // Every chunk interns into one table, so the object merge below compares keys by address.
+        if (!keys)
+            keys = std::make_shared<data::KeyTable>();
+
+        for (auto& chunk : chunks) {
+            pool.submit([&chunk, &keys, json_sv, is_object, key_policy = options.duplicate_keys]([[maybe_unused]] size_t worker_id) {
+                try {
+                    Parser parser {json_sv.substr(chunk.begin, chunk.end - chunk.begin)};
+                    DomHandler builder {nullptr, key_policy, keys};
+
+                    builder.beginBody(is_object);
+
+                    if (!parser.parseBodyEvents(builder, is_object)) {
+                        chunk.failed = true;
+                        return;
+                    }
+
+                    if (is_object)
+                        chunk.members = builder.releaseMembers();
+                    else
+                        chunk.items = builder.releaseItems();
+                } catch (...) {
+                    chunk.failed = true;
+                }
+            });
+        }
+
+        pool.waitIdle();
+
+        // Rerunning sequentially reports the exact error a plain parse would.
+        if (std::any_of(chunks.begin(), chunks.end(), [](const Chunk& chunk) { return chunk.failed; })) {
+            return parseSequential(name, json_sv, keys);
+        }
+
+        if (is_object) {
+            // Merging in chunk order applies the key policy exactly as one sequential pass would.
+            data::PropertyTable x_members = std::move(chunks.front().members);
+
+            for (size_t chunk_pos = 1; chunk_pos < chunks.size(); chunk_pos++) {
+                if (!x_members.merge(chunks[chunk_pos].members, options.duplicate_keys))
+                    return parseSequential(name, json_sv, keys);
+            }
+
+            return data::ToyJsonDocument {name, std::make_shared<data::AnyField>(data::ObjectField(std::move(x_members)))};
+        }
+
+        size_t total_items = 0;
+
+        for (const auto& chunk : chunks)
+            total_items += chunk.items.size();
+
+        data::ItemList x_items;
+
+        x_items.reserve(total_items);
+
+        for (auto& chunk : chunks)
+            std::move(chunk.items.begin(), chunk.items.end(), std::back_inserter(x_items));
+
+        return data::ToyJsonDocument {name, std::make_shared<data::AnyField>(data::ArrayField(std::move(x_items)))};
+    }
+
+    data::ToyJsonDocument ParallelParser::parseSequential(const std::string& name, std::string_view json_sv, std::shared_ptr<data::KeyTable> keys) const {
+        Parser parser {json_sv};
+
+        parser.setDuplicateKeyPolicy(options.duplicate_keys);
+        parser.setKeyTable(std::move(keys));
+
+        return parser.parseToADT(name);
+    }
+
+    size_t ParallelParser::getWorkerCount() const {
+        return pool.getWorkerCount();
+    }
+
+    /// @note The input is indexed one window at a time. Stage-1 state depends only on earlier bytes, so a window restarted just past an already-seen structural character indexes exactly as the whole input would.
+    bool ParallelParser::findSplits(std::string_view json_sv, size_t root_pos, size_t target_bytes, std::vector<size_t>& splits, size_t& root_end) {
+        StructuralIndex index {};
+        size_t depth = 0;
+        size_t next_target = root_pos + target_bytes;
+        size_t window_begin = root_pos;
+        size_t window_size = scan_window_size;
+
+        while (window_begin < json_sv.length()) {
+            size_t window_length = std::min(window_size, json_sv.length() - window_begin);
+
+            if (window_length > StructuralIndex::max_input_size)
+                return false;
+
+            index.build(json_sv.substr(window_begin, window_length));
+
+            size_t resume_pos = window_begin;
+
+            for (std::uint32_t offset : index.getPositions()) {
+                size_t pos = window_begin + offset;
+                char c = json_sv[pos];
+
+                if (c == '[' || c == '{') {
+                    depth++;
+                } else if (c == ']' || c == '}') {
+                    if (depth == 0)
+                        return false;
+
+                    if (--depth == 0) {
+                        root_end = pos;
+                        return true;
+                    }
+                } else if (c == ',') {
+                    if (depth == 1 && pos >= next_target) {
+                        splits.push_back(pos);
+                        next_target = pos + target_bytes;
+                    }
+                } else {
+                    continue; // quotes and literal starts are no safe place to restart
+                }
+
+                resume_pos = pos + 1;
+            }
+
+            if (window_begin + window_length == json_sv.length())
+                return false;
+
+            if (resume_pos == window_begin) {
+                window_size *= 2;
+                continue;
+            }
+
+            window_begin = resume_pos;
+            window_size = scan_window_size;
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ * @file ParseStats.cpp
+ * @author DrkWithT
+ * @brief Implements parse stats printing.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <ostream>
+#include <string_view>
+#include "frontend/ParseStats.hpp"
+
+namespace toyjson::frontend {
+    namespace {
+        constexpr std::array<std::string_view, token_type_count> token_names {
+            "unknown", "whitespace", "lbrace", "rbrace", "lbrack", "rbrack", "colon", "comma",
+            "null", "true", "false", "number", "string", "eof"
+        };
+
+        constexpr std::array<std::string_view, json_type_count> value_names {
+            "null", "boolean", "number", "string", "array", "object", "any"
+        };
+
+        [[nodiscard]] double toMilliseconds(std::chrono::nanoseconds span) {
+            return std::chrono::duration<double, std::milli>(span).count();
+        }
+    }
+
+    void printStats(std::ostream& out, const ParseStats& stats) {
+        out << "bytes lexed: " << stats.bytes_lexed << '\n';
+
+        for (size_t type_pos = 0; type_pos < token_type_count; type_pos++) {
+            if (stats.tokens[type_pos] != 0)
+                out << "tokens." << token_names[type_pos] << ": " << stats.tokens[type_pos] << '\n';
+        }
+
+        for (size_t type_pos = 0; type_pos < json_type_count; type_pos++) {
+            if (stats.values[type_pos] != 0)
+                out << "values." << value_names[type_pos] << ": " << stats.values[type_pos] << '\n';
+        }
+
+        out << "max depth: " << stats.max_depth << '\n'
+            << "logged errors: " << stats.logged_errors << '\n'
+            << "allocations: " << stats.allocs << '\n'
+            << "allocated bytes: " << stats.alloc_bytes << '\n'
+            << "lex ms: " << toMilliseconds(stats.lex_time) << '\n'
+            << "number ms: " << toMilliseconds(stats.number_time) << '\n'
+            << "string ms: " << toMilliseconds(stats.string_time) << '\n'
+            << "total ms: " << toMilliseconds(stats.total_time) << '\n';
+    }
+}
@@ -14,50 +14,196 @@
 #include <utility>
 #include <exception>
 #include <string>
-#include <sstream>
 #include <iostream>
 #include "data/Value.hpp"
 #include "frontend/ParseInfo.hpp"
 #include "frontend/Parser.hpp"
+#include "frontend/StringScan.hpp"
 #include "frontend/Token.hpp"
 
 namespace toyjson::frontend {
-    /* Usings */
-    using JsonNull = toyjson::data::NullField;
-    using JsonBoolean = toyjson::data::BooleanField;
-    using JsonNumber = toyjson::data::NumberField;
-    using JsonString = toyjson::data::StringField;
-    using JsonArray = toyjson::data::ArrayField;
-    using JsonObject = toyjson::data::ObjectField;
-    using JsonAny = toyjson::data::AnyField;
-
     /* Parse public impl. */
 
     Parser::Parser(std::string_view json_sv)
-        : lexer {json_sv}, current {.begin = 0, .length = 0, .type = TokenType::unknown}, previous {.begin = 0, .length = 0, .type = TokenType::unknown}, symbols {json_sv} {}
+        : Parser(json_sv, LexMode::indexed) {}
+
+    Parser::Parser(std::string_view json_sv, LexMode mode)
+        : lexer {createLexer(json_sv, mode)}, current {.begin = 0, .length = 0, .type = TokenType::unknown}, previous {.begin = 0, .length = 0, .type = TokenType::unknown}, symbols {json_sv}, scratch {}, lex_mode {mode}, key_policy {data::DuplicateKeyPolicy::keep_last}, key_table {}, stats {}, depth {0}, error {.status = ParseStatus::err_none, .offset = 0, .message = {}}, strict_tokens {false} {}
+
+    void Parser::reset(std::string_view json_sv) {
+        reset(json_sv, lex_mode);
+    }
+
+    void Parser::reset(std::string_view json_sv, LexMode mode) {
+        bool wants_index = mode == LexMode::indexed && json_sv.length() <= StructuralIndex::max_input_size;
+
+        if (auto* indexed = std::get_if<IndexedLexer>(&lexer); indexed != nullptr && wants_index)
+            indexed->reset(json_sv);
+        else if (auto* sequential = std::get_if<Lexer>(&lexer); sequential != nullptr && !wants_index)
+            sequential->reset(json_sv);
+        else
+            lexer = createLexer(json_sv, mode);
+
+        lex_mode = mode;
+        depth = 0;
+        current = {.begin = 0, .length = 0, .type = TokenType::unknown};
+        previous = {.begin = 0, .length = 0, .type = TokenType::unknown};
+        symbols = json_sv;
+    }
+
+    void Parser::setDuplicateKeyPolicy(data::DuplicateKeyPolicy policy) {
+        key_policy = policy;
+    }
+
+    void Parser::setKeyTable(std::shared_ptr<data::KeyTable> keys) {
+        key_table = std::move(keys);
+    }
 
     JsonDoc Parser::parseToADT(const std::string& name) {
-        consumeToken({}); // pass initial unknowns
+        auto doc = buildTree(name, nullptr, false);
+
+        throwOnError();
+
+        return doc;
+    }
+
+    JsonDoc Parser::parseToADT(const std::string& name, std::shared_ptr<utils::Arena> arena) {
+        auto doc = buildTree(name, std::move(arena), false);
+
+        throwOnError();
+
+        return doc;
+    }
+
+    StatsDoc Parser::parseWithStats(const std::string& name) {
+        auto doc = buildTree(name, nullptr, false);
+
+        throwOnError();
+
+        return StatsDoc {.doc = std::move(doc), .stats = stats};
+    }
+
+    JsonDoc Parser::parseToTape(const std::string& name) {
+        TapeHandler builder {};
+
+        parseEvents(builder);
+
+        return builder.toDocument(name);
+    }
 
-        auto x_root = parseValue();
+    JsonDoc Parser::parseToLazyTape(const std::string& name, std::shared_ptr<const void> source_owner) {
+        LazyTapeHandler builder {symbols};
 
-        return JsonDoc {name, std::move(x_root)};
+        parseEvents(builder);
+
+        return builder.toDocument(name, std::move(source_owner));
+    }
+
+    JsonDoc Parser::parseMappedFile(const std::string& file_path_str, bool populate) {
+        auto source = utils::InputSource::open(file_path_str, populate);
+        Parser parser {source->getText()};
+
+        return parser.parseToLazyTape(file_path_str, std::move(source));
+    }
+
+    const ParseStats& Parser::getStats() const {
+        return stats;
+    }
+
+    ParseResult<JsonDoc> Parser::tryParseToADT(const std::string& name) {
+        auto doc = buildTree(name, nullptr, true);
+
+        if (error.status != ParseStatus::err_none)
+            return error;
+
+        return doc;
+    }
+
+    ParseResult<JsonDoc> Parser::tryParseToADT(const std::string& name, std::shared_ptr<utils::Arena> arena) {
+        auto doc = buildTree(name, std::move(arena), true);
+
+        if (error.status != ParseStatus::err_none)
+            return error;
+
+        return doc;
+    }
+
+    ParseResult<JsonDoc> Parser::tryParseToTape(const std::string& name) {
+        TapeHandler builder {};
+
+        (void)runEvents(builder, true);
+
+        if (error.status != ParseStatus::err_none)
+            return error;
+
+        return builder.toDocument(name);
+    }
+
+    bool Parser::hasTrailingInput() const {
+        return !isAtEOF();
+    }
+
+    SourcePosition Parser::locateError(const ParseError& culprit_error) const {
+        return locateOffset(symbols, culprit_error.offset);
     }
 
     /* Parser private impl. */
 
-    std::string Parser::createErrorMsg(const Token& culprit, ParseStatus status, std::string_view msg_sv) {
-        std::ostringstream sout {};
+    std::variant<Lexer, IndexedLexer> Parser::createLexer(std::string_view json_sv, LexMode mode) {
+        if (mode == LexMode::indexed && json_sv.length() <= StructuralIndex::max_input_size)
+            return IndexedLexer {json_sv};
+
+        return Lexer {json_sv};
+    }
 
-        sout << toErrorName(status) << " at position " << culprit.begin << ": " << msg_sv;
+    std::string Parser::createErrorMsg(const ParseError& culprit_error) {
+        std::string msg {toErrorName(culprit_error.status)};
 
-        return sout.str();
+        msg.append(" at position ").append(std::to_string(culprit_error.offset)).append(": ").append(culprit_error.message).append("\n");
+
+        return msg;
     }
 
-    void Parser::logErrorBy(const Token& culprit, ParseStatus status, std::string_view msg_sv) const {
+    void Parser::logErrorBy(const Token& culprit, ParseStatus status, std::string_view msg_sv) {
+        if constexpr (utils::stats_enabled)
+            stats.logged_errors++;
+
         std::cerr << toErrorName(status) << " at position " << culprit.begin << ": " << msg_sv;
     }
 
+    bool Parser::fail(const Token& culprit, ParseStatus status, std::string_view msg_sv) {
+        if (error.status != ParseStatus::err_none)
+            return false;
+
+        error = ParseError {.status = status, .offset = culprit.begin, .message = msg_sv};
+
+        if (culprit.type == TokenType::eof) {
+            error.status = ParseStatus::err_unexpected_eof;
+            error.message = "Input ended early.";
+        } else if (culprit.type == TokenType::unknown && culprit.begin > 0 && symbols[culprit.begin - 1] == '\"' && culprit.begin + culprit.length == symbols.length()) {
+            // Both lexers report a string missing its closing quote as an unknown token running to the end.
+            error.status = ParseStatus::err_unterminated_string;
+            error.offset = culprit.begin - 1;
+            error.message = "String has no closing quote.";
+        } else if (culprit.type == TokenType::unknown) {
+            error.status = ParseStatus::err_unknown_token;
+            error.message = "Unknown token.";
+        }
+
+        return false;
+    }
+
+    void Parser::beginParse(bool strict) {
+        error = ParseError {.status = ParseStatus::err_none, .offset = 0, .message = {}};
+        depth = 0;
+        strict_tokens = strict;
+    }
+
+    void Parser::throwOnError() const {
+        if (error.status != ParseStatus::err_none)
+            throw std::runtime_error {createErrorMsg(error)};
+    }
+
     const Token& Parser::peekCurrent() const {
         return current;
     }
@@ -70,13 +216,29 @@ namespace toyjson::frontend {
         return peekCurrent().type == TokenType::eof;
     }
 
+    Token Parser::lexNext() {
+        utils::StatTimer lex_timer {stats.lex_time};
+        auto* indexed_lexer = std::get_if<IndexedLexer>(&lexer);
+        Token token = (indexed_lexer != nullptr) ? indexed_lexer->lexNext() : std::get<Lexer>(lexer).lexNext();
+
+        if constexpr (utils::stats_enabled) {
+            stats.tokens[static_cast<size_t>(token.type)]++;
+            stats.bytes_lexed = token.begin + token.length;
+        }
+
+        return token;
+    }
+
     Token Parser::doAdvance() {
         Token temp;
 
         do {
-            temp = lexer.lexNext();
+            temp = lexNext();
 
             if (temp.type == TokenType::unknown) {
+                if (strict_tokens)
+                    break;
+
                 logErrorBy(temp, ParseStatus::err_unknown_token, "Unknown token!\n");
                 continue;
             }
@@ -94,103 +256,126 @@ namespace toyjson::frontend {
         return matchTokenImpl(token, types);
     }
 
-    void Parser::consumeToken(std::initializer_list<TokenType> types) {
+    bool Parser::consumeToken(std::initializer_list<TokenType> types) {
         if (isAtEOF())
-            return;
+            return true;
 
         if (matchToken(current, types)) {
             previous = current;
             current = doAdvance();
-            return;
+            return true;
         }
 
-        throw std::runtime_error {createErrorMsg(current, ParseStatus::err_misplaced_token, "Unexpected token!\n")};
-    }
-
-    std::shared_ptr<JsonValue> Parser::parseValue() {
-        TokenType peeked_type = peekCurrent().type;
-
-        if (peeked_type == TokenType::lt_null) {
-            auto x_null = std::make_shared<JsonAny>(JsonNull());
-            consumeToken({});
-            return x_null;
-        } else if (peeked_type == TokenType::lt_true || peeked_type == TokenType::lt_false) {
-            auto x_bool = std::make_shared<JsonAny>(JsonBoolean(peeked_type == TokenType::lt_true));
-            consumeToken({});
-            return x_bool;
-        } else if (peeked_type == TokenType::lt_number) {
-            auto lexeme = getLexeme(peekCurrent(), symbols);
-            consumeToken({});
-            return std::make_shared<JsonAny>(JsonNumber(std::stod(lexeme)));
-        } else if (peeked_type == TokenType::lt_strbody) {
-            auto lexeme = getLexeme(peekCurrent(), symbols);
-            consumeToken({});
-            return std::make_shared<JsonAny>(JsonString(std::move(lexeme)));
-        } else if (peeked_type == TokenType::lbrack) {
-            return parseArray();
-        } else if (peeked_type == TokenType::lbrace) {
-            return parseObject();
-        } else {
-            throw std::runtime_error {createErrorMsg(peekCurrent(), ParseStatus::err_misplaced_token, "Unexpected token for value.\n")};
-        }
+        return fail(current, ParseStatus::err_misplaced_token, "Unexpected token!");
     }
 
-    std::shared_ptr<JsonValue> Parser::parseArray() {
-        consumeToken({}); // pass '[' symbol
+    bool Parser::expectToken(TokenType type, ParseStatus status, std::string_view msg_sv) {
+        if (current.type != type)
+            return fail(current, status, msg_sv);
 
-        std::vector<std::shared_ptr<JsonValue>> x_items {};
+        return consumeToken({});
+    }
 
-        while (!isAtEOF()) {
-            if (matchToken(peekCurrent(), {TokenType::rbrack})) {
-                consumeToken({});
-                break;
-            }
+    JsonDoc Parser::buildTree(const std::string& name, std::shared_ptr<utils::Arena> arena, bool strict) {
+        DomHandler builder {std::move(arena), key_policy, key_table};
 
-            auto x_item = parseValue();
-            x_items.emplace_back(std::move(x_item));
+        // The tree builder only stops early on a rejected key, which is still the current token.
+        if (!runEvents(builder, strict) && builder.hasDuplicateKey())
+            fail(peekCurrent(), ParseStatus::err_duplicate_key, "Repeated property name.");
 
-            if (matchToken(peekCurrent(), {TokenType::comma})) {
-                consumeToken({});
-            } else if (matchToken(peekCurrent(), {TokenType::rbrack})) {
-                continue;
-            } else {
-                throw std::runtime_error {createErrorMsg(peekCurrent(), ParseStatus::err_misplaced_token, "Unexpected token in Array.\n")};
-            }
+        if (error.status != ParseStatus::err_none)
+            return JsonDoc {};
+
+        return builder.toDocument(name);
+    }
+
+    bool Parser::convertNumber(const Token& token, NumberLiteral& literal) {
+        utils::StatTimer number_timer {stats.number_time};
+
+        if (!parseNumber(viewLexeme(token, symbols), literal))
+            return fail(token, ParseStatus::err_bad_number, "Malformed number.");
+
+        return true;
+    }
+
+    bool Parser::skipValue() {
+        SkipHandler skipper {};
+
+        return emitValue(skipper);
+    }
+
+    bool Parser::bindKey(std::string_view& key) {
+        const Token& key_token = peekCurrent();
+
+        if (key_token.type != TokenType::lt_strbody)
+            return fail(key_token, ParseStatus::err_expected_key, "Expected a property name.");
+
+        if (!decodeToScratch(key_token, key))
+            return false;
+
+        consumeToken({});
+
+        return expectToken(TokenType::colon, ParseStatus::err_expected_colon, "Expected ':' after property name.");
+    }
+
+    bool Parser::bindSeparator(TokenType closer, std::string_view msg_sv, bool& at_closer) {
+        if (matchToken(peekCurrent(), {TokenType::comma}))
+            return consumeToken({});
+
+        if (matchToken(peekCurrent(), {closer})) {
+            at_closer = true;
+            return true;
         }
 
-        return std::make_shared<JsonAny>(JsonArray(std::move(x_items)));
+        return fail(peekCurrent(), ParseStatus::err_expected_separator, msg_sv);
     }
 
-    std::shared_ptr<JsonValue> Parser::parseObject() {
-        consumeToken({}); // pass '{' symbol
+    bool Parser::bindCloser(TokenType closer) {
+        if (isAtEOF())
+            return fail(peekCurrent(), ParseStatus::err_unexpected_eof, "Unterminated container.");
+
+        return consumeToken({closer});
+    }
 
-        std::map<std::string, std::shared_ptr<JsonValue>> x_dict {};
+    /// @note Only checks that every escape decodes, and sets escaped if there is any. Nothing is decoded or copied.
+    bool Parser::checkEscapes(const Token& token, bool& escaped) {
+        utils::StatTimer string_timer {stats.string_time};
+        auto raw = viewLexeme(token, symbols);
+        size_t escape_pos = findBackslash(raw, 0);
 
-        while (!isAtEOF()) {
-            if (matchToken(peekCurrent(), {TokenType::rbrace})) {
-                consumeToken({});
-                break;
-            }
+        escaped = escape_pos != std::string_view::npos;
 
-            auto x_name = getLexeme(peekCurrent(), symbols);
+        while (escape_pos != std::string_view::npos) {
+            char utf8_buffer[4];
+            size_t utf8_length = 0;
+            size_t consumed = decodeEscape(raw, escape_pos, utf8_buffer, utf8_length);
 
-            consumeToken({TokenType::lt_strbody});
+            if (consumed == 0)
+                return fail(token, ParseStatus::err_bad_escape, "Malformed escape in string.");
 
-            consumeToken({TokenType::colon});
+            escape_pos = findBackslash(raw, escape_pos + consumed);
+        }
 
-            auto x_prop_val = parseValue();
+        return true;
+    }
 
-            x_dict[x_name] = std::move(x_prop_val);
+    /// @note Escape-free strings are returned as views of the source, so only escaped ones pay for the scratch copy.
+    bool Parser::decodeToScratch(const Token& token, std::string_view& text) {
+        utils::StatTimer string_timer {stats.string_time};
+        auto raw = viewLexeme(token, symbols);
 
-            if (matchToken(peekCurrent(), {TokenType::comma})) {
-                consumeToken({});
-            } else if (matchToken(peekCurrent(), {TokenType::rbrace})) {
-                continue;
-            } else {
-                throw std::runtime_error {createErrorMsg(peekCurrent(), ParseStatus::err_misplaced_token, "Unexpected token in Object.\n")};
-            }
+        if (findBackslash(raw, 0) == std::string_view::npos) {
+            text = raw;
+            return true;
         }
 
-        return std::make_shared<JsonAny>(JsonObject(std::move(x_dict)));
+        scratch.clear();
+
+        if (!appendDecoded(raw, scratch))
+            return fail(token, ParseStatus::err_bad_escape, "Malformed escape in string.");
+
+        text = scratch;
+
+        return true;
     }
 }
@@ -0,0 +1,60 @@
+/**
+ * @file ParserPool.cpp
+ * @author DrkWithT
+ * @brief Implements thread-local parser reuse.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <utility>
+#include <vector>
+#include "frontend/ParserPool.hpp"
+
+namespace toyjson::frontend {
+    namespace {
+        thread_local std::vector<std::unique_ptr<Parser>> idle_parsers {};
+    }
+
+    /* ParserLease public impl. */
+
+    ParserLease::ParserLease(std::unique_ptr<Parser> x_parser)
+        : parser {std::move(x_parser)} {}
+
+    ParserLease::~ParserLease() {
+        if (!parser || idle_parsers.size() >= max_pooled_parsers)
+            return;
+
+        idle_parsers.push_back(std::move(parser));
+    }
+
+    Parser& ParserLease::operator*() const {
+        return *parser;
+    }
+
+    Parser* ParserLease::operator->() const {
+        return parser.get();
+    }
+
+    /* Pool functions impl. */
+
+    ParserLease acquireParser(std::string_view json_sv, LexMode mode) {
+        if (idle_parsers.empty())
+            return ParserLease {std::make_unique<Parser>(json_sv, mode)};
+
+        auto parser = std::move(idle_parsers.back());
+
+        idle_parsers.pop_back();
+        parser->reset(json_sv, mode);
+        parser->setDuplicateKeyPolicy(data::DuplicateKeyPolicy::keep_last);
+        parser->setKeyTable(nullptr);
+
+        return ParserLease {std::move(parser)};
+    }
+
+    void trimParserPool() {
+        idle_parsers.clear();
+        idle_parsers.shrink_to_fit();
+    }
+}
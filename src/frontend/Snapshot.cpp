@@ -0,0 +1,511 @@
+/**
+ * @file Snapshot.cpp
+ * @author DrkWithT
+ * @brief Implements binary tape snapshots and their mapped reload.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "utils/InputSource.hpp"
+#include "frontend/Parser.hpp"
+#include "frontend/Snapshot.hpp"
+
+namespace toyjson::frontend {
+    namespace {
+        constexpr std::array<char, 8> snapshot_magic {'T', 'O', 'Y', 'J', 'S', 'N', 'A', 'P'};
+        constexpr std::uint32_t byte_order_tag = 0x01020304;
+        constexpr size_t write_chunk_nodes = 4096;
+
+        /// @note Fields are copied in and out with memcpy, so the header needs no particular alignment in the file.
+        struct SnapshotHeader {
+            std::array<char, 8> magic;
+            std::uint32_t version;
+            std::uint32_t byte_order;   // byte_order_tag as the writer stored it
+            std::uint64_t node_count;
+            std::uint64_t string_bytes;
+            std::uint64_t source_bytes;
+            std::int64_t source_mtime_ns;
+            std::uint64_t checksum;     // over the node and string sections
+            std::uint32_t node_size;
+            std::uint32_t reserved;
+        };
+
+        static_assert(sizeof(SnapshotHeader) == 64 && std::is_trivially_copyable_v<SnapshotHeader>);
+        static_assert(sizeof(SnapshotHeader) % alignof(data::TapeNode) == 0, "Mapped nodes must follow the header aligned");
+        static_assert(sizeof(data::TapeNode) == 16 && std::is_trivially_copyable_v<data::TapeNode>);
+
+        [[noreturn]] void throwErrno(const std::string& what) {
+            throw std::system_error {errno, std::generic_category(), what};
+        }
+
+        constexpr std::uint64_t checksum_seed = 0x9e3779b97f4a7c15ULL;
+        constexpr std::uint64_t checksum_factor = 0x9fb21c651e98df25ULL;
+
+        /**
+         * @brief Word-at-a-time multiply-rotate hash. Catches truncation and bit rot, not tampering.
+         * @note Chunks hash the same as their concatenation while every chunk but the last holds whole words, so writers can hash as they stream.
+         */
+        [[nodiscard]] std::uint64_t mixChecksum(std::uint64_t hash, std::string_view bytes) {
+            size_t pos = 0;
+
+            for (; pos + 8 <= bytes.length(); pos += 8) {
+                std::uint64_t word;
+
+                std::memcpy(&word, bytes.data() + pos, 8);
+                hash = std::rotl((hash ^ word) * checksum_factor, 29);
+            }
+
+            if (pos < bytes.length()) {
+                std::uint64_t tail = 0;
+
+                std::memcpy(&tail, bytes.data() + pos, bytes.length() - pos);
+                hash = std::rotl((hash ^ tail) * checksum_factor, 29);
+            }
+
+            return hash;
+        }
+
+        [[nodiscard]] std::uint64_t finishChecksum(std::uint64_t hash, std::uint64_t total_bytes) {
+            hash = (hash ^ total_bytes) * checksum_factor;
+
+            return hash ^ (hash >> 32);
+        }
+
+        /// @brief Copies a node field by field into zeroed bytes, so padding never reaches the file or its checksum.
+        void storeNode(char* out, const data::TapeNode& node) {
+            std::memset(out, 0, sizeof(data::TapeNode));
+            std::memcpy(out + offsetof(data::TapeNode, type), &node.type, sizeof(node.type));
+            std::memcpy(out + offsetof(data::TapeNode, flags), &node.flags, sizeof(node.flags));
+            std::memcpy(out + offsetof(data::TapeNode, length), &node.length, sizeof(node.length));
+            std::memcpy(out + offsetof(data::TapeNode, payload), &node.payload, sizeof(node.payload));
+        }
+
+        /* Flattening of tree and lazy documents. */
+
+        void flattenValue(data::TapeBuilder& builder, const data::IJsonValue& value) {
+            value.visit([&builder](const auto& field) {
+                using Field = std::remove_cvref_t<decltype(field)>;
+
+                if constexpr (std::is_same_v<Field, data::BooleanField>) {
+                    builder.pushBoolean(field.asBoolean());
+                } else if constexpr (std::is_same_v<Field, data::NumberField>) {
+                    if (field.getNumberKind() == data::NumberKind::j_int64)
+                        builder.pushNumber(field.asInt64());
+                    else if (field.getNumberKind() == data::NumberKind::j_uint64)
+                        builder.pushNumber(field.asUInt64());
+                    else
+                        builder.pushNumber(field.asDouble());
+                } else if constexpr (std::is_same_v<Field, data::StringField>) {
+                    builder.pushString(field.asString());
+                } else if constexpr (std::is_same_v<Field, data::ArrayField>) {
+                    builder.beginArray();
+
+                    for (const auto& item : field)
+                        flattenValue(builder, item);
+
+                    builder.endArray();
+                } else if constexpr (std::is_same_v<Field, data::ObjectField>) {
+                    builder.beginObject();
+
+                    for (const auto& member : field) {
+                        builder.pushKey(member.key->text);
+                        flattenValue(builder, *member.value);
+                    }
+
+                    builder.endObject();
+                } else {
+                    builder.pushNull();
+                }
+            });
+        }
+
+        void flattenValue(data::TapeBuilder& builder, data::TapeValue value) {
+            switch (value.getType()) {
+                case data::JsonType::j_boolean:
+                    builder.pushBoolean(value.asBoolean());
+                    break;
+                case data::JsonType::j_number:
+                    if (value.getNumberKind() == data::NumberKind::j_int64)
+                        builder.pushNumber(value.asInt64());
+                    else if (value.getNumberKind() == data::NumberKind::j_uint64)
+                        builder.pushNumber(value.asUInt64());
+                    else
+                        builder.pushNumber(value.asNumber());
+                    break;
+                case data::JsonType::j_string:
+                    builder.pushString(value.asString());
+                    break;
+                case data::JsonType::j_array: {
+                    builder.beginArray();
+
+                    size_t count = value.getLength();
+                    auto item = value.getFirstChild();
+
+                    for (size_t pos = 0; pos < count; pos++, item = item.getNextSibling())
+                        flattenValue(builder, item);
+
+                    builder.endArray();
+                    break;
+                }
+                case data::JsonType::j_object: {
+                    builder.beginObject();
+
+                    size_t count = value.getPropertyCount();
+                    auto key = value.getFirstChild();
+
+                    for (size_t member = 0; member < count; member++) {
+                        auto member_value = key.getNextSibling();
+
+                        builder.pushKey(key.asString());
+                        flattenValue(builder, member_value);
+                        key = member_value.getNextSibling();
+                    }
+
+                    builder.endObject();
+                    break;
+                }
+                default:
+                    builder.pushNull();
+                    break;
+            }
+        }
+
+        /// @brief Returns the tape to write: the document's own when it holds no lazy spans, else a flattened copy kept in scratch.
+        [[nodiscard]] const data::JsonTape& pickTape(const data::ToyJsonDocument& doc, data::JsonTape& scratch) {
+            data::TapeBuilder builder {};
+
+            if (doc.getStorageMode() == data::StorageMode::tape) {
+                const auto& tape = doc.getTape();
+
+                if (tape.isEmpty())
+                    throw std::runtime_error {"Cannot snapshot an empty document"};
+                else if (!tape.isLazy())
+                    return tape;
+
+                flattenValue(builder, tape.getRoot());
+            } else {
+                if (!doc.getRoot())
+                    throw std::runtime_error {"Cannot snapshot an empty document"};
+
+                flattenValue(builder, *doc.getRoot());
+            }
+
+            scratch = builder.release();
+
+            return scratch;
+        }
+
+        /* Snapshot file checks. */
+
+        /// @brief Checks each node alone: known type, no lazy flags, strings inside the pool and container ends past the container.
+        [[nodiscard]] bool checkNodeFields(std::span<const data::TapeNode> nodes, size_t pool_bytes) {
+            for (size_t node_index = 0; node_index < nodes.size(); node_index++) {
+                const auto& node = nodes[node_index];
+
+                if ((node.flags & (data::tape_lazy_bit | data::tape_escaped_bit)) != 0)
+                    return false;
+
+                switch (node.type) {
+                    case data::JsonType::j_null:
+                    case data::JsonType::j_boolean:
+                        break;
+                    case data::JsonType::j_number:
+                        if ((node.flags & data::tape_kind_mask) > static_cast<std::uint8_t>(data::NumberKind::j_uint64))
+                            return false;
+                        break;
+                    case data::JsonType::j_string:
+                        if (node.payload > pool_bytes || node.length > pool_bytes - node.payload)
+                            return false;
+                        break;
+                    case data::JsonType::j_array:
+                    case data::JsonType::j_object:
+                        if (node.payload <= node_index || node.payload > nodes.size())
+                            return false;
+                        break;
+                    default:
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+        /// @brief Checks that the nodes form exactly one value: every container's children fill it to its end index, and object members start with a string key.
+        [[nodiscard]] bool checkNodeTree(std::span<const data::TapeNode> nodes) {
+            struct OpenContainer {
+                std::uint64_t end;
+                std::uint64_t remaining;
+                bool is_object;
+            };
+
+            std::vector<OpenContainer> open {};
+            size_t cursor = 0;
+
+            auto takeValue = [&nodes, &open, &cursor]() {
+                if (cursor >= nodes.size())
+                    return false;
+
+                const auto& node = nodes[cursor];
+
+                if (node.type == data::JsonType::j_array || node.type == data::JsonType::j_object)
+                    open.push_back({.end = node.payload, .remaining = node.length, .is_object = node.type == data::JsonType::j_object});
+
+                cursor++;
+
+                return true;
+            };
+
+            if (!takeValue())
+                return false;
+
+            while (!open.empty()) {
+                auto& top = open.back();
+
+                if (top.remaining == 0) {
+                    if (cursor != top.end)
+                        return false;
+
+                    open.pop_back();
+                    continue;
+                }
+
+                top.remaining--;
+
+                if (top.is_object) {
+                    if (cursor >= nodes.size() || nodes[cursor].type != data::JsonType::j_string)
+                        return false;
+
+                    cursor++;
+                }
+
+                if (!takeValue())
+                    return false;
+            }
+
+            return cursor == nodes.size();
+        }
+
+        [[nodiscard]] std::optional<data::ToyJsonDocument> mapSnapshot(const std::string& snapshot_path_str, const std::string& title, SourceStamp stamp, SnapshotCheck check) {
+            std::shared_ptr<const utils::InputSource> file;
+
+            try {
+                file = utils::InputSource::open(snapshot_path_str);
+            } catch (const std::system_error&) {
+                return std::nullopt;
+            }
+
+            auto text = file->getText();
+            SnapshotHeader header;
+
+            if (text.length() < sizeof(SnapshotHeader))
+                return std::nullopt;
+
+            std::memcpy(&header, text.data(), sizeof(SnapshotHeader));
+
+            if (header.magic != snapshot_magic || header.version != snapshot_version || header.byte_order != byte_order_tag || header.node_size != sizeof(data::TapeNode))
+                return std::nullopt;
+            else if (header.source_bytes != stamp.bytes || header.source_mtime_ns != stamp.mtime_ns)
+                return std::nullopt;
+
+            size_t body_bytes = text.length() - sizeof(SnapshotHeader);
+
+            if (header.node_count == 0 || header.node_count > UINT32_MAX || header.node_count > body_bytes / sizeof(data::TapeNode))
+                return std::nullopt;
+
+            size_t node_bytes = header.node_count * sizeof(data::TapeNode);
+
+            if (header.string_bytes != body_bytes - node_bytes)
+                return std::nullopt;
+
+            const char* node_start = text.data() + sizeof(SnapshotHeader);
+
+            if (reinterpret_cast<std::uintptr_t>(node_start) % alignof(data::TapeNode) != 0)
+                return std::nullopt;
+
+            std::span<const data::TapeNode> nodes {reinterpret_cast<const data::TapeNode*>(node_start), header.node_count};
+            auto pool = text.substr(sizeof(SnapshotHeader) + node_bytes);
+
+            if (check == SnapshotCheck::full) {
+                auto checksum = finishChecksum(mixChecksum(mixChecksum(checksum_seed, {node_start, node_bytes}), pool), body_bytes);
+
+                if (checksum != header.checksum)
+                    return std::nullopt;
+                else if (!checkNodeFields(nodes, pool.length()) || !checkNodeTree(nodes))
+                    return std::nullopt;
+            }
+
+            return data::ToyJsonDocument {title, data::JsonTape {nodes, pool}, std::move(file)};
+        }
+
+        void writeAll(int fd, const char* bytes, size_t count, const std::string& path_str) {
+            while (count > 0) {
+                ssize_t written = ::write(fd, bytes, count);
+
+                if (written < 0) {
+                    if (errno == EINTR)
+                        continue;
+
+                    throwErrno("Cannot write " + path_str);
+                }
+
+                bytes += written;
+                count -= static_cast<size_t>(written);
+            }
+        }
+
+        /// @brief Removes a temporary snapshot on scope exit unless it was renamed into place.
+        class TempFile {
+            public:
+                explicit TempFile(std::string x_path_str)
+                    : path_str(std::move(x_path_str)), fd {-1}, kept {false} {
+                    fd = ::open(path_str.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+                    if (fd < 0)
+                        throwErrno("Cannot create " + path_str);
+                }
+
+                ~TempFile() {
+                    if (fd >= 0)
+                        ::close(fd);
+
+                    if (!kept)
+                        ::unlink(path_str.c_str());
+                }
+
+                TempFile(const TempFile& other) = delete;
+                TempFile& operator=(const TempFile& other) = delete;
+
+                [[nodiscard]] int get() const {
+                    return fd;
+                }
+
+                [[nodiscard]] const std::string& getPath() const {
+                    return path_str;
+                }
+
+                void renameTo(const std::string& final_path_str) {
+                    int closing_fd = fd;
+
+                    fd = -1;
+
+                    if (::close(closing_fd) != 0)
+                        throwErrno("Cannot write " + path_str);
+
+                    if (::rename(path_str.c_str(), final_path_str.c_str()) != 0)
+                        throwErrno("Cannot replace " + final_path_str);
+
+                    kept = true;
+                }
+
+            private:
+                std::string path_str;
+                int fd;
+                bool kept;
+        };
+    }
+
+    SourceStamp stampFile(const std::string& file_path_str) {
+        struct stat info {};
+
+        if (::stat(file_path_str.c_str(), &info) != 0)
+            throwErrno("Cannot stat " + file_path_str);
+
+        return SourceStamp {
+            .bytes = static_cast<std::uint64_t>(info.st_size),
+            .mtime_ns = static_cast<std::int64_t>(info.st_mtim.tv_sec) * 1'000'000'000 + info.st_mtim.tv_nsec
+        };
+    }
+
+    void writeSnapshot(const std::string& snapshot_path_str, const data::ToyJsonDocument& doc, SourceStamp stamp) {
+        static std::atomic<unsigned> temp_serial {0};
+
+        data::JsonTape scratch {};
+        const auto& tape = pickTape(doc, scratch);
+        auto nodes = tape.getNodes();
+        auto pool = tape.getStringPool();
+
+        SnapshotHeader header {
+            .magic = snapshot_magic,
+            .version = snapshot_version,
+            .byte_order = byte_order_tag,
+            .node_count = nodes.size(),
+            .string_bytes = pool.length(),
+            .source_bytes = stamp.bytes,
+            .source_mtime_ns = stamp.mtime_ns,
+            .checksum = 0,
+            .node_size = sizeof(data::TapeNode),
+            .reserved = 0
+        };
+
+        TempFile temp {snapshot_path_str + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(temp_serial.fetch_add(1))};
+        std::vector<char> chunk(write_chunk_nodes * sizeof(data::TapeNode));
+        std::uint64_t checksum = checksum_seed;
+
+        // The header goes last, once the checksum is known.
+        if (::lseek(temp.get(), sizeof(SnapshotHeader), SEEK_SET) < 0)
+            throwErrno("Cannot write " + temp.getPath());
+
+        for (size_t first = 0; first < nodes.size(); first += write_chunk_nodes) {
+            size_t count = std::min(nodes.size() - first, write_chunk_nodes);
+            size_t chunk_bytes = count * sizeof(data::TapeNode);
+
+            for (size_t node_pos = 0; node_pos < count; node_pos++)
+                storeNode(chunk.data() + node_pos * sizeof(data::TapeNode), nodes[first + node_pos]);
+
+            checksum = mixChecksum(checksum, {chunk.data(), chunk_bytes});
+            writeAll(temp.get(), chunk.data(), chunk_bytes, temp.getPath());
+        }
+
+        writeAll(temp.get(), pool.data(), pool.length(), temp.getPath());
+        header.checksum = finishChecksum(mixChecksum(checksum, pool), nodes.size() * sizeof(data::TapeNode) + pool.length());
+
+        if (::lseek(temp.get(), 0, SEEK_SET) < 0)
+            throwErrno("Cannot write " + temp.getPath());
+
+        writeAll(temp.get(), reinterpret_cast<const char*>(&header), sizeof(header), temp.getPath());
+        temp.renameTo(snapshot_path_str);
+    }
+
+    std::optional<data::ToyJsonDocument> openSnapshot(const std::string& snapshot_path_str, SourceStamp stamp, SnapshotCheck check) {
+        return mapSnapshot(snapshot_path_str, snapshot_path_str, stamp, check);
+    }
+
+    SnapshotLoad loadWithSnapshot(const std::string& json_path_str, const std::string& snapshot_path_str, SnapshotCheck check) {
+        auto stamp = stampFile(json_path_str);
+
+        if (auto mapped = mapSnapshot(snapshot_path_str, json_path_str, stamp, check); mapped)
+            return SnapshotLoad {.doc = std::move(*mapped), .origin = SnapshotOrigin::mapped, .refreshed = false};
+
+        auto source = utils::InputSource::open(json_path_str);
+        Parser parser {source->getText()};
+        auto doc = parser.parseToTape(json_path_str);
+        bool refreshed = true;
+
+        try {
+            writeSnapshot(snapshot_path_str, doc, stamp);
+        } catch (const std::system_error&) {
+            refreshed = false;
+        }
+
+        return SnapshotLoad {.doc = std::move(doc), .origin = SnapshotOrigin::reparsed, .refreshed = refreshed};
+    }
+}
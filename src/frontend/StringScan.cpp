@@ -0,0 +1,291 @@
+/**
+ * @file StringScan.cpp
+ * @author DrkWithT
+ * @brief Implements vectorized string body scanning and escape decoding.
+ * @date 2024-05-23
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <bit>
+#include <cstdint>
+#include "utils/Simd.hpp"
+#include "frontend/StringScan.hpp"
+
+#ifdef TOYJSON_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace toyjson::frontend {
+    namespace {
+        constexpr size_t npos = std::string_view::npos;
+
+        /// @brief Finds the first byte equal to either needle in data[pos, length).
+        using FindPairFn = size_t (*)(const char* data, size_t length, size_t pos, char first, char second);
+
+        size_t findPairScalar(const char* data, size_t length, size_t pos, char first, char second) {
+            for (; pos < length; pos++) {
+                if (data[pos] == first || data[pos] == second)
+                    return pos;
+            }
+
+            return npos;
+        }
+
+#ifdef TOYJSON_X86_SIMD
+        __attribute__((target("sse2"))) size_t findPairSse2(const char* data, size_t length, size_t pos, char first, char second) {
+            const __m128i first_v = _mm_set1_epi8(first);
+            const __m128i second_v = _mm_set1_epi8(second);
+
+            for (; pos + 16 <= length; pos += 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+                __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, first_v), _mm_cmpeq_epi8(chunk, second_v));
+                auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(hits));
+
+                if (bits != 0)
+                    return pos + std::countr_zero(bits);
+            }
+
+            return findPairScalar(data, length, pos, first, second);
+        }
+
+        __attribute__((target("avx2"))) size_t findPairAvx2(const char* data, size_t length, size_t pos, char first, char second) {
+            const __m256i first_v = _mm256_set1_epi8(first);
+            const __m256i second_v = _mm256_set1_epi8(second);
+
+            for (; pos + 32 <= length; pos += 32) {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+                __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, first_v), _mm256_cmpeq_epi8(chunk, second_v));
+                auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+
+                if (bits != 0)
+                    return pos + std::countr_zero(bits);
+            }
+
+            // The tail runs legacy-encoded SSE, which stalls on dirty upper AVX state unless it is cleared first.
+            _mm256_zeroupper();
+
+            return findPairSse2(data, length, pos, first, second);
+        }
+#endif
+
+        FindPairFn pickFindPair() {
+#ifdef TOYJSON_X86_SIMD
+            if (utils::detectSimdLevel() == utils::SimdLevel::avx2)
+                return findPairAvx2;
+
+            return findPairSse2;
+#else
+            return findPairScalar;
+#endif
+        }
+
+        size_t findPair(std::string_view text, size_t pos, char first, char second) {
+            static const FindPairFn find_fn = pickFindPair();
+
+            return find_fn(text.data(), text.length(), pos, first, second);
+        }
+
+        using FindSpecialFn = size_t (*)(const char* data, size_t length, size_t pos);
+
+        size_t findSpecialScalar(const char* data, size_t length, size_t pos) {
+            for (; pos < length; pos++) {
+                if (data[pos] == '\"' || data[pos] == '\\' || static_cast<unsigned char>(data[pos]) < 0x20)
+                    return pos;
+            }
+
+            return npos;
+        }
+
+#ifdef TOYJSON_X86_SIMD
+        /// @note Unsigned min(byte, 0x1F) equals the byte only for control characters, as SSE2 lacks an unsigned compare.
+        __attribute__((target("sse2"))) size_t findSpecialSse2(const char* data, size_t length, size_t pos) {
+            const __m128i quote_v = _mm_set1_epi8('\"');
+            const __m128i backslash_v = _mm_set1_epi8('\\');
+            const __m128i control_max_v = _mm_set1_epi8(0x1F);
+
+            for (; pos + 16 <= length; pos += 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+                __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote_v), _mm_cmpeq_epi8(chunk, backslash_v));
+
+                hits = _mm_or_si128(hits, _mm_cmpeq_epi8(_mm_min_epu8(chunk, control_max_v), chunk));
+
+                auto bits = static_cast<std::uint32_t>(_mm_movemask_epi8(hits));
+
+                if (bits != 0)
+                    return pos + std::countr_zero(bits);
+            }
+
+            return findSpecialScalar(data, length, pos);
+        }
+
+        __attribute__((target("avx2"))) size_t findSpecialAvx2(const char* data, size_t length, size_t pos) {
+            const __m256i quote_v = _mm256_set1_epi8('\"');
+            const __m256i backslash_v = _mm256_set1_epi8('\\');
+            const __m256i control_max_v = _mm256_set1_epi8(0x1F);
+
+            for (; pos + 32 <= length; pos += 32) {
+                __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+                __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote_v), _mm256_cmpeq_epi8(chunk, backslash_v));
+
+                hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, control_max_v), chunk));
+
+                auto bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(hits));
+
+                if (bits != 0)
+                    return pos + std::countr_zero(bits);
+            }
+
+            _mm256_zeroupper();
+
+            return findSpecialSse2(data, length, pos);
+        }
+#endif
+
+        FindSpecialFn pickFindSpecial() {
+#ifdef TOYJSON_X86_SIMD
+            if (utils::detectSimdLevel() == utils::SimdLevel::avx2)
+                return findSpecialAvx2;
+
+            return findSpecialSse2;
+#else
+            return findSpecialScalar;
+#endif
+        }
+
+        [[nodiscard]] constexpr int hexValue(char c) {
+            if (c >= '0' && c <= '9')
+                return c - '0';
+            else if (c >= 'a' && c <= 'f')
+                return c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                return c - 'A' + 10;
+
+            return -1;
+        }
+
+        /// @brief Reads the 4 hex digits after "\\u" at raw[pos]. Returns -1 if malformed.
+        [[nodiscard]] long readCodeUnit(std::string_view raw, size_t pos) {
+            if (pos + 6 > raw.length() || raw[pos] != '\\' || raw[pos + 1] != 'u')
+                return -1;
+
+            long unit = 0;
+
+            for (size_t i = pos + 2; i < pos + 6; i++) {
+                int digit = hexValue(raw[i]);
+
+                if (digit < 0)
+                    return -1;
+
+                unit = (unit << 4) | digit;
+            }
+
+            return unit;
+        }
+
+        [[nodiscard]] size_t encodeUtf8(std::uint32_t code_point, char (&utf8_out)[4]) {
+            if (code_point < 0x80) {
+                utf8_out[0] = static_cast<char>(code_point);
+                return 1;
+            } else if (code_point < 0x800) {
+                utf8_out[0] = static_cast<char>(0xC0 | (code_point >> 6));
+                utf8_out[1] = static_cast<char>(0x80 | (code_point & 0x3F));
+                return 2;
+            } else if (code_point < 0x10000) {
+                utf8_out[0] = static_cast<char>(0xE0 | (code_point >> 12));
+                utf8_out[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+                utf8_out[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+                return 3;
+            }
+
+            utf8_out[0] = static_cast<char>(0xF0 | (code_point >> 18));
+            utf8_out[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+            utf8_out[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            utf8_out[3] = static_cast<char>(0x80 | (code_point & 0x3F));
+            return 4;
+        }
+    }
+
+    size_t findQuoteOrBackslash(std::string_view text, size_t pos) {
+        return findPair(text, pos, '\"', '\\');
+    }
+
+    size_t findBackslash(std::string_view text, size_t pos) {
+        return findPair(text, pos, '\\', '\\');
+    }
+
+    size_t findStringSpecial(std::string_view text, size_t pos) {
+        static const FindSpecialFn find_fn = pickFindSpecial();
+
+        return find_fn(text.data(), text.length(), pos);
+    }
+
+    size_t findStringEnd(std::string_view text, size_t pos) {
+        size_t hit = findQuoteOrBackslash(text, pos);
+
+        while (hit != npos && text[hit] == '\\')
+            hit = findQuoteOrBackslash(text, hit + 2);
+
+        return (hit != npos && hit < text.length()) ? hit : npos;
+    }
+
+    size_t decodeEscape(std::string_view raw, size_t pos, char (&utf8_out)[4], size_t& utf8_length) {
+        if (pos + 1 >= raw.length())
+            return 0;
+
+        utf8_length = 1;
+
+        switch (raw[pos + 1]) {
+            case '\"':
+                utf8_out[0] = '\"';
+                return 2;
+            case '\\':
+                utf8_out[0] = '\\';
+                return 2;
+            case '/':
+                utf8_out[0] = '/';
+                return 2;
+            case 'b':
+                utf8_out[0] = '\b';
+                return 2;
+            case 'f':
+                utf8_out[0] = '\f';
+                return 2;
+            case 'n':
+                utf8_out[0] = '\n';
+                return 2;
+            case 'r':
+                utf8_out[0] = '\r';
+                return 2;
+            case 't':
+                utf8_out[0] = '\t';
+                return 2;
+            case 'u':
+                break;
+            default:
+                return 0;
+        }
+
+        long high = readCodeUnit(raw, pos);
+
+        if (high < 0 || (high >= 0xDC00 && high <= 0xDFFF))
+            return 0;
+
+        if (high < 0xD800 || high > 0xDBFF) {
+            utf8_length = encodeUtf8(static_cast<std::uint32_t>(high), utf8_out);
+            return 6;
+        }
+
+        long low = readCodeUnit(raw, pos + 6);
+
+        if (low < 0xDC00 || low > 0xDFFF)
+            return 0;
+
+        auto code_point = static_cast<std::uint32_t>(0x10000 + ((high - 0xD800) << 10) + (low - 0xDC00));
+
+        utf8_length = encodeUtf8(code_point, utf8_out);
+
+        return 12;
+    }
+}
@@ -0,0 +1,330 @@
+/**
+ * @file StructuralIndex.cpp
+ * @author DrkWithT
+ * @brief Implements the stage-1 structural indexer and the lexer consuming it.
+ * @date 2024-05-22
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <bit>
+#include <cstring>
+#include "frontend/Lexer.hpp"
+#include "frontend/StructuralIndex.hpp"
+
+#ifdef TOYJSON_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace toyjson::frontend {
+    /* Block classification */
+
+    namespace {
+        constexpr size_t block_size = 64;
+
+        /// @brief One bit per byte of a 64-byte block for each character class the indexer cares about.
+        struct BlockMasks {
+            std::uint64_t quote;
+            std::uint64_t backslash;
+            std::uint64_t whitespace;
+            std::uint64_t op;
+        };
+
+        /// @brief Carried state between consecutive blocks.
+        struct ScanState {
+            std::uint64_t prev_odd_backslash;
+            std::uint64_t prev_in_string;
+            std::uint64_t prev_literal;
+        };
+
+        using ClassifyFn = BlockMasks (*)(const char* block);
+
+        BlockMasks classifyScalar(const char* block) {
+            BlockMasks masks {0, 0, 0, 0};
+
+            for (size_t i = 0; i < block_size; i++) {
+                std::uint64_t bit = std::uint64_t {1} << i;
+
+                switch (block[i]) {
+                    case '\"':
+                        masks.quote |= bit;
+                        break;
+                    case '\\':
+                        masks.backslash |= bit;
+                        break;
+                    case ' ':
+                    case '\t':
+                    case '\r':
+                    case '\n':
+                        masks.whitespace |= bit;
+                        break;
+                    case '{':
+                    case '}':
+                    case '[':
+                    case ']':
+                    case ':':
+                    case ',':
+                        masks.op |= bit;
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            return masks;
+        }
+
+#ifdef TOYJSON_X86_SIMD
+        __attribute__((target("sse4.2"))) BlockMasks classifySse42(const char* block) {
+            const __m128i op_set = _mm_setr_epi8('{', '}', '[', ']', ':', ',', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i space_set = _mm_setr_epi8(' ', '\t', '\r', '\n', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i quote = _mm_set1_epi8('\"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            constexpr int set_mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK;
+
+            BlockMasks masks {0, 0, 0, 0};
+
+            for (size_t lane = 0; lane < block_size; lane += 16) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + lane));
+
+                auto op_bits = static_cast<std::uint16_t>(_mm_cvtsi128_si32(_mm_cmpestrm(op_set, 6, chunk, 16, set_mode)));
+                auto space_bits = static_cast<std::uint16_t>(_mm_cvtsi128_si32(_mm_cmpestrm(space_set, 4, chunk, 16, set_mode)));
+                auto quote_bits = static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)));
+                auto backslash_bits = static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)));
+
+                masks.op |= std::uint64_t {op_bits} << lane;
+                masks.whitespace |= std::uint64_t {space_bits} << lane;
+                masks.quote |= std::uint64_t {quote_bits} << lane;
+                masks.backslash |= std::uint64_t {backslash_bits} << lane;
+            }
+
+            return masks;
+        }
+
+        __attribute__((target("avx2"))) std::uint64_t maskOf(__m256i lo, __m256i hi, __m256i needle) {
+            auto lo_bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+            auto hi_bits = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+
+            return std::uint64_t {lo_bits} | (std::uint64_t {hi_bits} << 32);
+        }
+
+        __attribute__((target("avx2"))) BlockMasks classifyAvx2(const char* block) {
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+
+            // '[' and ']' differ from '{' and '}' only by bit 0x20, so folding that bit in halves the bracket compares.
+            const __m256i case_bit = _mm256_set1_epi8(0x20);
+            __m256i lo_folded = _mm256_or_si256(lo, case_bit);
+            __m256i hi_folded = _mm256_or_si256(hi, case_bit);
+
+            BlockMasks masks {};
+
+            masks.quote = maskOf(lo, hi, _mm256_set1_epi8('\"'));
+            masks.backslash = maskOf(lo, hi, _mm256_set1_epi8('\\'));
+            masks.whitespace = maskOf(lo, hi, _mm256_set1_epi8(' ')) | maskOf(lo, hi, _mm256_set1_epi8('\t'))
+                | maskOf(lo, hi, _mm256_set1_epi8('\r')) | maskOf(lo, hi, _mm256_set1_epi8('\n'));
+            masks.op = maskOf(lo_folded, hi_folded, _mm256_set1_epi8('{')) | maskOf(lo_folded, hi_folded, _mm256_set1_epi8('}'))
+                | maskOf(lo, hi, _mm256_set1_epi8(':')) | maskOf(lo, hi, _mm256_set1_epi8(','));
+
+            return masks;
+        }
+#endif
+
+        ClassifyFn pickClassifier(utils::SimdLevel level) {
+#ifdef TOYJSON_X86_SIMD
+            if (level == utils::SimdLevel::avx2)
+                return classifyAvx2;
+            else if (level == utils::SimdLevel::sse42)
+                return classifySse42;
+#else
+            (void)level;
+#endif
+
+            return classifyScalar;
+        }
+
+        /// @brief Marks every byte directly preceded by an odd-length run of backslashes, i.e. every escaped byte. Runs may span blocks.
+        std::uint64_t findEscaped(std::uint64_t backslash, std::uint64_t& prev_odd_backslash) {
+            constexpr std::uint64_t even_bits = 0x5555555555555555ULL;
+            constexpr std::uint64_t odd_bits = ~even_bits;
+
+            std::uint64_t start_edges = backslash & ~(backslash << 1);
+            std::uint64_t even_start_mask = even_bits ^ prev_odd_backslash;
+            std::uint64_t even_starts = start_edges & even_start_mask;
+            std::uint64_t odd_starts = start_edges & ~even_start_mask;
+            std::uint64_t even_carries = backslash + even_starts;
+            std::uint64_t odd_carries = backslash + odd_starts;
+            bool ends_odd_backslash = odd_carries < backslash;
+
+            odd_carries |= prev_odd_backslash;
+            prev_odd_backslash = ends_odd_backslash ? 1 : 0;
+
+            std::uint64_t even_carry_ends = even_carries & ~backslash;
+            std::uint64_t odd_carry_ends = odd_carries & ~backslash;
+
+            return (even_carry_ends & odd_bits) | (odd_carry_ends & even_bits);
+        }
+
+        /// @brief Turns each bit into the XOR of itself and all lower bits, so bits between quote pairs end up set.
+        constexpr std::uint64_t prefixXor(std::uint64_t bits) {
+            bits ^= bits << 1;
+            bits ^= bits << 2;
+            bits ^= bits << 4;
+            bits ^= bits << 8;
+            bits ^= bits << 16;
+            bits ^= bits << 32;
+
+            return bits;
+        }
+
+        std::uint64_t findStructurals(const BlockMasks& masks, ScanState& state) {
+            std::uint64_t escaped = findEscaped(masks.backslash, state.prev_odd_backslash);
+            std::uint64_t quotes = masks.quote & ~escaped;
+            std::uint64_t in_string = prefixXor(quotes) ^ state.prev_in_string;
+
+            state.prev_in_string = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+
+            std::uint64_t literal = ~(masks.whitespace | masks.op | quotes | in_string);
+            std::uint64_t literal_starts = literal & ~((literal << 1) | state.prev_literal);
+
+            state.prev_literal = literal >> 63;
+
+            return (masks.op & ~in_string) | quotes | literal_starts;
+        }
+
+        void flushBits(std::vector<std::uint32_t>& positions, std::uint64_t bits, size_t base) {
+            while (bits != 0) {
+                positions.push_back(static_cast<std::uint32_t>(base + std::countr_zero(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    /* StructuralIndex */
+
+    StructuralIndex::StructuralIndex()
+        : positions {} {}
+
+    void StructuralIndex::build(std::string_view source) {
+        build(source, utils::detectSimdLevel());
+    }
+
+    void StructuralIndex::build(std::string_view source, utils::SimdLevel level) {
+        ClassifyFn classify = pickClassifier(level);
+        ScanState state {0, 0, 0};
+        size_t length = source.length();
+        size_t full_end = length - (length % block_size);
+
+        positions.clear();
+
+        for (size_t base = 0; base < full_end; base += block_size)
+            flushBits(positions, findStructurals(classify(source.data() + base), state), base);
+
+        // The tail is copied into a space-padded block so no kernel ever reads past the input.
+        if (full_end < length) {
+            char tail[block_size];
+
+            std::memset(tail, ' ', block_size);
+            std::memcpy(tail, source.data() + full_end, length - full_end);
+
+            flushBits(positions, findStructurals(classify(tail), state), full_end);
+        }
+    }
+
+    const std::vector<std::uint32_t>& StructuralIndex::getPositions() const {
+        return positions;
+    }
+
+    /* IndexedLexer public impl */
+
+    IndexedLexer::IndexedLexer(std::string_view sv_arg)
+        : index {}, symbols {sv_arg}, cursor {0} {
+        index.build(sv_arg);
+    }
+
+    void IndexedLexer::reset(std::string_view sv_arg) {
+        symbols = sv_arg;
+        cursor = 0;
+        index.build(sv_arg);
+    }
+
+    Token IndexedLexer::lexNext() {
+        return widenToken(lexNextCompact());
+    }
+
+    CompactToken IndexedLexer::lexNextCompact() {
+        const auto& positions = index.getPositions();
+
+        if (cursor >= positions.size())
+            return {.begin = static_cast<std::uint32_t>(symbols.length()), .length = 1, .type = TokenType::eof};
+
+        std::uint32_t begin = positions[cursor++];
+
+        switch (symbols[begin]) {
+            case '{':
+                return {.begin = begin, .length = 1, .type = TokenType::lbrace};
+            case '}':
+                return {.begin = begin, .length = 1, .type = TokenType::rbrace};
+            case '[':
+                return {.begin = begin, .length = 1, .type = TokenType::lbrack};
+            case ']':
+                return {.begin = begin, .length = 1, .type = TokenType::rbrack};
+            case ':':
+                return {.begin = begin, .length = 1, .type = TokenType::colon};
+            case ',':
+                return {.begin = begin, .length = 1, .type = TokenType::comma};
+            case '\"':
+                return lexString(begin);
+            default:
+                break;
+        }
+
+        return lexLiteral(begin);
+    }
+
+    /* IndexedLexer private impl */
+
+    /// @note Nothing inside a string is indexed, so the closing quote is always the very next position.
+    CompactToken IndexedLexer::lexString(std::uint32_t begin) {
+        const auto& positions = index.getPositions();
+
+        if (cursor >= positions.size()) {
+            return {
+                .begin = begin + 1,
+                .length = static_cast<std::uint32_t>(symbols.length() - begin - 1),
+                .type = TokenType::unknown
+            };
+        }
+
+        std::uint32_t end = positions[cursor++];
+
+        return {.begin = begin + 1, .length = end - begin - 1, .type = TokenType::lt_strbody};
+    }
+
+    CompactToken IndexedLexer::lexLiteral(std::uint32_t begin) {
+        size_t limit = symbols.length();
+        size_t end = begin;
+        bool wordy = true;
+
+        while (end < limit) {
+            char c = symbols[end];
+
+            if (isSpacing(c) || c == '\"' || c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',')
+                break;
+
+            wordy = wordy && isWordSymbol(c);
+            end++;
+        }
+
+        auto lexeme = symbols.substr(begin, end - begin);
+        CompactToken result {.begin = begin, .length = static_cast<std::uint32_t>(lexeme.length()), .type = TokenType::unknown};
+
+        if (isNumberStart(lexeme.front()))
+            result.type = isJsonNumber(lexeme) ? TokenType::lt_number : TokenType::unknown;
+        else if (wordy)
+            result.type = lookupKeyword(lexeme);
+
+        return result;
+    }
+}
@@ -8,7 +8,6 @@
  * 
  */
 
-#include <sstream>
 #include "frontend/Token.hpp"
 
 namespace toyjson::frontend {
@@ -22,17 +21,6 @@ namespace toyjson::frontend {
     }
 
     std::string getLexeme(const Token& token, std::string_view source_sv) {
-        std::ostringstream sout {};
-
-        auto lexeme_cursor = source_sv.begin() + token.begin;
-        auto lexeme_end = lexeme_cursor + token.length;
-
-        while (lexeme_cursor != lexeme_end) {
-            char c = *lexeme_cursor;
-            sout << c;
-            lexeme_cursor++;
-        }
-
-        return sout.str();
+        return std::string {source_sv.substr(token.begin, token.length)};
     }
 }
\ No newline at end of file
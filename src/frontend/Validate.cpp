@@ -0,0 +1,289 @@
+/**
+ * @file Validate.cpp
+ * @author DrkWithT
+ * @brief Implements allocation-free JSON validation.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <array>
+#include <cstdint>
+#include "utils/Utf8.hpp"
+#include "frontend/Lexer.hpp"
+#include "frontend/NumberParse.hpp"
+#include "frontend/StringScan.hpp"
+#include "frontend/Validate.hpp"
+
+namespace toyjson::frontend {
+    namespace {
+        constexpr size_t npos = std::string_view::npos;
+
+        constexpr ParseError no_error {.status = ParseStatus::err_none, .offset = 0, .message = {}};
+
+        /// @brief Walks the grammar with an explicit state instead of recursion, so each open container costs one bit.
+        class GrammarCheck {
+            public:
+                explicit GrammarCheck(std::string_view x_text) noexcept
+                    : text {x_text}, error {no_error}, pos {0}, depth {0}, object_bits {} {}
+
+                /// @return The first grammar error, or an err_none error if the text is one complete value.
+                [[nodiscard]] ParseError run() noexcept {
+                    Expect expect = Expect::value;
+
+                    skipSpacing();
+
+                    while (true) {
+                        if (pos >= text.length()) {
+                            if (expect == Expect::after_value && depth == 0)
+                                return no_error;
+
+                            fail(ParseStatus::err_unexpected_eof, pos, (depth == 0) ? "Input ended before a value." : "Input ended inside a container.");
+                            return error;
+                        }
+
+                        char c = text[pos];
+                        bool passed = false;
+
+                        switch (expect) {
+                            case Expect::value:
+                                passed = checkValue(c, expect);
+                                break;
+                            case Expect::key:
+                                passed = checkKey(c);
+                                expect = Expect::value;
+                                break;
+                            case Expect::after_value:
+                                passed = checkAfterValue(c, expect);
+                                break;
+                        }
+
+                        if (!passed)
+                            return error;
+
+                        skipSpacing();
+                    }
+                }
+
+            private:
+                enum class Expect {
+                    value,
+                    key,
+                    after_value
+                };
+
+                std::string_view text;
+                ParseError error;
+                size_t pos;
+                size_t depth;
+                std::array<std::uint64_t, max_validate_depth / 64> object_bits; // bit set when the container at that depth is an Object
+
+                bool fail(ParseStatus status, size_t offset, std::string_view msg) noexcept {
+                    error = ParseError {.status = status, .offset = offset, .message = msg};
+                    return false;
+                }
+
+                void skipSpacing() noexcept {
+                    while (pos < text.length() && isSpacing(text[pos]))
+                        pos++;
+                }
+
+                [[nodiscard]] bool isDigitAt(size_t offset) const noexcept {
+                    return offset < text.length() && isDigit(text[offset]);
+                }
+
+                void skipDigits() noexcept {
+                    while (isDigitAt(pos))
+                        pos++;
+                }
+
+                [[nodiscard]] bool isObjectOpen() const noexcept {
+                    size_t slot = depth - 1;
+
+                    return (object_bits[slot / 64] >> (slot % 64)) & 1;
+                }
+
+                void pushContainer(bool is_object) noexcept {
+                    std::uint64_t bit = std::uint64_t {1} << (depth % 64);
+
+                    if (is_object)
+                        object_bits[depth / 64] |= bit;
+                    else
+                        object_bits[depth / 64] &= ~bit;
+
+                    depth++;
+                }
+
+                [[nodiscard]] bool checkValue(char c, Expect& expect) noexcept {
+                    if (c == '{' || c == '[') {
+                        if (depth == max_validate_depth)
+                            return fail(ParseStatus::err_too_deep, pos, "Nesting too deep.");
+
+                        bool is_object = c == '{';
+
+                        pushContainer(is_object);
+                        pos++;
+                        skipSpacing();
+
+                        if (pos < text.length() && text[pos] == (is_object ? '}' : ']')) {
+                            pos++;
+                            depth--;
+                            expect = Expect::after_value;
+                        } else {
+                            expect = is_object ? Expect::key : Expect::value;
+                        }
+
+                        return true;
+                    }
+
+                    expect = Expect::after_value;
+
+                    if (c == '\"')
+                        return checkString();
+                    else if (isNumberStart(c))
+                        return checkNumber();
+                    else if (isWordSymbol(c))
+                        return checkLiteral();
+                    else if (c == '}' || c == ']' || c == ',' || c == ':')
+                        return fail(ParseStatus::err_expected_value, pos, "Expected a value.");
+
+                    return fail(ParseStatus::err_unknown_token, pos, "Unknown token.");
+                }
+
+                [[nodiscard]] bool checkKey(char c) noexcept {
+                    if (c != '\"')
+                        return fail(ParseStatus::err_expected_key, pos, "Expected a string key.");
+
+                    if (!checkString())
+                        return false;
+
+                    skipSpacing();
+
+                    if (pos >= text.length())
+                        return fail(ParseStatus::err_unexpected_eof, pos, "Input ended inside a container.");
+                    else if (text[pos] != ':')
+                        return fail(ParseStatus::err_expected_colon, pos, "Expected ':' after key.");
+
+                    pos++;
+
+                    return true;
+                }
+
+                /// @note A ',' must be followed by another entry, so trailing commas fail as a missing value or key.
+                [[nodiscard]] bool checkAfterValue(char c, Expect& expect) noexcept {
+                    if (depth == 0)
+                        return fail(ParseStatus::err_trailing_content, pos, "Unexpected text after the value.");
+
+                    bool in_object = isObjectOpen();
+
+                    if (c == ',') {
+                        pos++;
+                        expect = in_object ? Expect::key : Expect::value;
+                    } else if (c == (in_object ? '}' : ']')) {
+                        pos++;
+                        depth--;
+                    } else {
+                        return fail(ParseStatus::err_expected_separator, pos, in_object ? "Expected ',' or '}' in Object." : "Expected ',' or ']' in Array.");
+                    }
+
+                    return true;
+                }
+
+                /// @brief Steps over a string from its opening quote, checking escapes and rejecting raw control characters.
+                [[nodiscard]] bool checkString() noexcept {
+                    size_t quote_pos = pos;
+                    size_t hit = findStringSpecial(text, pos + 1);
+
+                    while (hit != npos) {
+                        char c = text[hit];
+
+                        if (c == '\"') {
+                            pos = hit + 1;
+                            return true;
+                        } else if (c != '\\') {
+                            return fail(ParseStatus::err_control_char, hit, "Raw control character in string.");
+                        }
+
+                        char utf8_buffer[4];
+                        size_t utf8_length = 0;
+                        size_t consumed = decodeEscape(text, hit, utf8_buffer, utf8_length);
+
+                        if (consumed == 0)
+                            return fail(ParseStatus::err_bad_escape, hit, "Invalid escape sequence.");
+
+                        hit = findStringSpecial(text, hit + consumed);
+                    }
+
+                    return fail(ParseStatus::err_unterminated_string, quote_pos, "Unterminated string.");
+                }
+
+                /// @note Matches the grammar of isJsonNumber in one pass. Any numeric character left over means the lexer's lexeme would not match either.
+                [[nodiscard]] bool checkNumber() noexcept {
+                    size_t start = pos;
+
+                    if (text[pos] == '-')
+                        pos++;
+
+                    if (!isDigitAt(pos))
+                        return fail(ParseStatus::err_bad_number, start, "Malformed number.");
+
+                    if (text[pos] == '0')
+                        pos++;
+                    else
+                        skipDigits();
+
+                    if (pos < text.length() && text[pos] == '.') {
+                        pos++;
+
+                        if (!isDigitAt(pos))
+                            return fail(ParseStatus::err_bad_number, start, "Malformed number.");
+
+                        skipDigits();
+                    }
+
+                    if (pos < text.length() && (text[pos] == 'e' || text[pos] == 'E')) {
+                        pos++;
+
+                        if (pos < text.length() && (text[pos] == '+' || text[pos] == '-'))
+                            pos++;
+
+                        if (!isDigitAt(pos))
+                            return fail(ParseStatus::err_bad_number, start, "Malformed number.");
+
+                        skipDigits();
+                    }
+
+                    if (pos < text.length() && isNumeric(text[pos]))
+                        return fail(ParseStatus::err_bad_number, start, "Malformed number.");
+
+                    return true;
+                }
+
+                [[nodiscard]] bool checkLiteral() noexcept {
+                    size_t start = pos;
+
+                    while (pos < text.length() && isWordSymbol(text[pos]))
+                        pos++;
+
+                    if (lookupKeyword(text.substr(start, pos - start)) == TokenType::unknown)
+                        return fail(ParseStatus::err_unknown_token, start, "Unknown literal.");
+
+                    return true;
+                }
+        };
+    }
+
+    /// @note The UTF-8 pass runs over the whole buffer on its own, as a separate streaming pass keeps the grammar loop free of per-byte classification.
+    ParseResult<void> validate(std::string_view json_sv) {
+        ParseError grammar_error = GrammarCheck {json_sv}.run();
+        size_t bad_utf8_pos = utils::findInvalidUtf8(json_sv);
+
+        if (bad_utf8_pos != npos && (grammar_error.status == ParseStatus::err_none || bad_utf8_pos < grammar_error.offset))
+            return ParseError {.status = ParseStatus::err_invalid_utf8, .offset = bad_utf8_pos, .message = "Invalid UTF-8 sequence."};
+        else if (grammar_error.status != ParseStatus::err_none)
+            return grammar_error;
+
+        return {};
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ * @file Arena.cpp
+ * @author DrkWithT
+ * @brief Implements the bump allocator arena.
+ * @date 2024-05-21
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include "utils/Arena.hpp"
+
+namespace toyjson::utils {
+    Arena::Arena()
+        : Arena(default_block_size) {}
+
+    Arena::Arena(size_t x_block_size)
+        : blocks {}, block_size {x_block_size}, current {0}, offset {0}, used {0} {}
+
+    void Arena::reset() {
+        current = 0;
+        offset = 0;
+        used = 0;
+    }
+
+    void Arena::release() {
+        blocks.clear();
+        reset();
+    }
+
+    size_t Arena::getBytesUsed() const {
+        return used;
+    }
+
+    size_t Arena::getBytesReserved() const {
+        size_t total = 0;
+
+        for (const auto& block : blocks)
+            total += block.size;
+
+        return total;
+    }
+
+    void* Arena::do_allocate(size_t bytes, size_t alignment) {
+        if (void* result = tryBump(bytes, alignment); result != nullptr)
+            return result;
+
+        // Move on to the next retained block that fits before growing, so a reset arena serves the same workload without touching malloc.
+        while (current + 1 < blocks.size()) {
+            current++;
+            offset = 0;
+
+            if (void* result = tryBump(bytes, alignment); result != nullptr)
+                return result;
+        }
+
+        size_t new_size = std::max(block_size, bytes + alignment);
+
+        blocks.push_back({.memory = std::make_unique_for_overwrite<std::byte[]>(new_size), .size = new_size});
+        current = blocks.size() - 1;
+        offset = 0;
+
+        return tryBump(bytes, alignment);
+    }
+
+    void Arena::do_deallocate([[maybe_unused]] void* ptr, [[maybe_unused]] size_t bytes, [[maybe_unused]] size_t alignment) {
+        // memory is only reclaimed in bulk by reset() or release()
+    }
+
+    bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+
+    void* Arena::tryBump(size_t bytes, size_t alignment) {
+        if (current >= blocks.size())
+            return nullptr;
+
+        auto& block = blocks[current];
+        auto base = reinterpret_cast<std::uintptr_t>(block.memory.get());
+        size_t aligned = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+
+        if (aligned + bytes > block.size)
+            return nullptr;
+
+        offset = aligned + bytes;
+        used += bytes;
+
+        return block.memory.get() + aligned;
+    }
+}
@@ -8,24 +8,25 @@
  * 
  */
 
-#include <algorithm>
-#include <memory>
 #include <fstream>
 #include "utils/FileUtils.hpp"
 
 namespace toyjson::utils {
+    /// @note Reads straight into the result, so the text is copied once and embedded NUL bytes are kept.
     [[nodiscard]] std::string readFile(const std::string& file_path_str) {
-        std::ifstream reader {file_path_str};
+        std::ifstream reader {file_path_str, std::ios::binary};
 
         reader.seekg(0, reader.end);
-        size_t length = reader.tellg();
+        auto length = static_cast<std::streamoff>(reader.tellg());
         reader.seekg(0, reader.beg);
 
-        auto buffer = std::make_unique<char[]>(length + 1);
-        std::fill(buffer.get(), buffer.get() + length, '\0');
+        if (!reader.good() || length <= 0)
+            return std::string {};
 
-        if (reader.read(buffer.get(), length).good())
-            return std::string {buffer.get()};
+        std::string content(static_cast<size_t>(length), '\0');
+
+        if (reader.read(content.data(), length).good())
+            return content;
 
         return std::string {};
     }
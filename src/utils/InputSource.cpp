@@ -0,0 +1,137 @@
+/**
+ * @file InputSource.cpp
+ * @author DrkWithT
+ * @brief Implements mapped and buffered input sources.
+ * @date 2024-05-26
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "utils/InputSource.hpp"
+
+namespace toyjson::utils {
+    namespace {
+        constexpr size_t read_chunk_size = 64 * 1024;
+
+        [[noreturn]] void throwErrno(const std::string& what) {
+            throw std::system_error {errno, std::generic_category(), what};
+        }
+
+        /// @brief Closes a descriptor on scope exit.
+        class FdGuard {
+            public:
+                explicit FdGuard(int x_fd)
+                    : fd {x_fd} {}
+
+                ~FdGuard() {
+                    if (fd >= 0)
+                        ::close(fd);
+                }
+
+                FdGuard(const FdGuard& other) = delete;
+                FdGuard& operator=(const FdGuard& other) = delete;
+
+                [[nodiscard]] int get() const {
+                    return fd;
+                }
+
+            private:
+                int fd;
+        };
+    }
+
+    InputSource::InputSource(const char* x_data, size_t x_length)
+        : buffer {}, data {x_data}, length {x_length}, backing {InputBacking::mapped} {}
+
+    InputSource::InputSource(std::string x_buffer)
+        : buffer(std::move(x_buffer)), data {nullptr}, length {0}, backing {InputBacking::buffered} {
+        data = buffer.data();
+        length = buffer.length();
+    }
+
+    InputSource::~InputSource() {
+        if (backing == InputBacking::mapped)
+            ::munmap(const_cast<char*>(data), length);
+    }
+
+    std::shared_ptr<const InputSource> InputSource::open(const std::string& file_path_str, bool populate) {
+        if (file_path_str == "-")
+            return readDescriptor(STDIN_FILENO);
+
+        FdGuard file {::open(file_path_str.c_str(), O_RDONLY | O_CLOEXEC)};
+
+        if (file.get() < 0)
+            throwErrno("Cannot open " + file_path_str);
+
+        struct stat info {};
+
+        if (::fstat(file.get(), &info) != 0)
+            throwErrno("Cannot stat " + file_path_str);
+
+        // Empty files cannot be mapped, and pipes or devices have no fixed size to map.
+        if (!S_ISREG(info.st_mode) || info.st_size == 0)
+            return readDescriptor(file.get());
+
+        auto map_length = static_cast<size_t>(info.st_size);
+        int map_flags = MAP_PRIVATE;
+
+#ifdef MAP_POPULATE
+        if (populate)
+            map_flags |= MAP_POPULATE;
+#else
+        (void)populate;
+#endif
+
+        void* mapping = ::mmap(nullptr, map_length, PROT_READ, map_flags, file.get(), 0);
+
+        if (mapping == MAP_FAILED)
+            throwErrno("Cannot map " + file_path_str);
+
+        ::madvise(mapping, map_length, MADV_SEQUENTIAL);
+
+        return std::shared_ptr<const InputSource> {new InputSource(static_cast<const char*>(mapping), map_length)};
+    }
+
+    std::shared_ptr<const InputSource> InputSource::readDescriptor(int fd) {
+        std::string content;
+        size_t filled = 0;
+
+        while (true) {
+            content.resize(filled + read_chunk_size);
+
+            ssize_t got = ::read(fd, content.data() + filled, read_chunk_size);
+
+            if (got < 0) {
+                if (errno == EINTR)
+                    continue;
+
+                throwErrno("Cannot read input");
+            }
+
+            if (got == 0)
+                break;
+
+            filled += static_cast<size_t>(got);
+        }
+
+        content.resize(filled);
+
+        return std::shared_ptr<const InputSource> {new InputSource(std::move(content))};
+    }
+
+    std::string_view InputSource::getText() const {
+        return {data, length};
+    }
+
+    InputBacking InputSource::getBacking() const {
+        return backing;
+    }
+}
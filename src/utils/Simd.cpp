@@ -0,0 +1,32 @@
+/**
+ * @file Simd.cpp
+ * @author DrkWithT
+ * @brief Implements runtime CPU feature detection.
+ * @date 2024-05-22
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "utils/Simd.hpp"
+
+namespace toyjson::utils {
+    SimdLevel detectSimdLevel() {
+#ifdef TOYJSON_X86_SIMD
+        static const SimdLevel level = []() {
+            __builtin_cpu_init();
+
+            if (__builtin_cpu_supports("avx2"))
+                return SimdLevel::avx2;
+            else if (__builtin_cpu_supports("sse4.2"))
+                return SimdLevel::sse42;
+
+            return SimdLevel::scalar;
+        }();
+
+        return level;
+#else
+        return SimdLevel::scalar;
+#endif
+    }
+}
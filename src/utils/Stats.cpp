@@ -0,0 +1,45 @@
+/**
+ * @file Stats.cpp
+ * @author DrkWithT
+ * @brief Implements allocation tallies for instrumented builds.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <atomic>
+#include "utils/Stats.hpp"
+
+namespace toyjson::utils {
+    namespace {
+        thread_local AllocTally thread_tally {0, 0, 0};
+        std::atomic<size_t> process_allocs {0};
+        std::atomic<size_t> process_frees {0};
+        std::atomic<size_t> process_bytes {0};
+    }
+
+    void countAlloc(size_t size) noexcept {
+        thread_tally.allocs++;
+        thread_tally.bytes += size;
+        process_allocs.fetch_add(1, std::memory_order_relaxed);
+        process_bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void countFree() noexcept {
+        thread_tally.frees++;
+        process_frees.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    AllocTally readThreadAllocs() {
+        return thread_tally;
+    }
+
+    AllocTally readProcessAllocs() {
+        return AllocTally {
+            .allocs = process_allocs.load(std::memory_order_relaxed),
+            .frees = process_frees.load(std::memory_order_relaxed),
+            .bytes = process_bytes.load(std::memory_order_relaxed)
+        };
+    }
+}
@@ -0,0 +1,132 @@
+/**
+ * @file ThreadPool.cpp
+ * @author DrkWithT
+ * @brief Implements the work-stealing thread pool.
+ * @date 2024-05-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <algorithm>
+#include <utility>
+#include "utils/ThreadPool.hpp"
+
+namespace toyjson::utils {
+    ThreadPool::ThreadPool(size_t worker_count)
+        : queues {}, workers {}, state_lock {}, wake {}, idle {}, queued {0}, unfinished {0}, next_queue {0}, stopping {false} {
+        if (worker_count == 0)
+            worker_count = std::max(1U, std::thread::hardware_concurrency());
+
+        for (size_t worker_id = 0; worker_id < worker_count; worker_id++)
+            queues.emplace_back(std::make_unique<WorkQueue>());
+
+        for (size_t worker_id = 0; worker_id < worker_count; worker_id++)
+            workers.emplace_back([this, worker_id]() { runWorker(worker_id); });
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard guard {state_lock};
+            stopping = true;
+        }
+
+        wake.notify_all();
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    void ThreadPool::submit(Task task) {
+        size_t target = 0;
+
+        {
+            std::lock_guard guard {state_lock};
+            target = next_queue;
+            next_queue = (next_queue + 1) % queues.size();
+            unfinished++;
+        }
+
+        {
+            std::lock_guard guard {queues[target]->lock};
+            queues[target]->tasks.push_back(std::move(task));
+        }
+
+        {
+            std::lock_guard guard {state_lock};
+            queued++;
+        }
+
+        wake.notify_one();
+    }
+
+    void ThreadPool::waitIdle() {
+        std::unique_lock guard {state_lock};
+
+        idle.wait(guard, [this]() { return unfinished == 0; });
+    }
+
+    size_t ThreadPool::getWorkerCount() const {
+        return workers.size();
+    }
+
+    bool ThreadPool::tryTake(size_t worker_id, Task& task) {
+        {
+            auto& own = *queues[worker_id];
+            std::lock_guard guard {own.lock};
+
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.front());
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+
+        for (size_t step = 1; step < queues.size(); step++) {
+            auto& victim = *queues[(worker_id + step) % queues.size()];
+            std::lock_guard guard {victim.lock};
+
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::runWorker(size_t worker_id) {
+        Task task;
+
+        while (true) {
+            {
+                std::unique_lock guard {state_lock};
+
+                wake.wait(guard, [this]() { return queued > 0 || stopping; });
+
+                if (queued == 0 && stopping)
+                    return;
+
+                queued--;
+            }
+
+            // The reservation above guarantees a task is in some deque, though a scan can race past it.
+            while (!tryTake(worker_id, task))
+                std::this_thread::yield();
+
+            task(worker_id);
+            task = nullptr;
+
+            bool drained = false;
+
+            {
+                std::lock_guard guard {state_lock};
+                drained = --unfinished == 0;
+            }
+
+            if (drained)
+                idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,314 @@
+/**
+ * @file Utf8.cpp
+ * @author DrkWithT
+ * @brief Implements vectorized UTF-8 validation.
+ * @date 2024-05-28
+ * @note The vector kernels follow Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte": three nibble lookups classify each byte pair, and a saturating subtract checks 3 and 4 byte sequences.
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <cstdint>
+#include <cstring>
+#include "utils/Simd.hpp"
+#include "utils/Utf8.hpp"
+
+#ifdef TOYJSON_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace toyjson::utils {
+    namespace {
+        constexpr size_t npos = std::string_view::npos;
+
+        using FindInvalidFn = size_t (*)(const char* data, size_t length);
+
+        size_t findInvalidScalar(const char* data, size_t length) {
+            return findInvalidUtf8Scalar({data, length}, 0);
+        }
+
+#ifdef TOYJSON_X86_SIMD
+        /// @brief Finds the start of the sequence holding the byte before a flagged block. A block's errors never begin earlier, since a sequence spans at most 4 bytes.
+        [[nodiscard]] size_t backToLead(const char* data, size_t pos) {
+            size_t floor = (pos >= 4) ? pos - 4 : 0;
+
+            while (pos > floor) {
+                pos--;
+
+                if ((static_cast<std::uint8_t>(data[pos]) & 0xC0) != 0x80)
+                    return pos;
+            }
+
+            return floor;
+        }
+
+        /* Error bits set by the lookups. A byte pair is invalid when all three lookups share a bit. */
+
+        constexpr std::int8_t too_short = 1 << 0;  // lead byte not followed by enough continuations
+        constexpr std::int8_t too_long = 1 << 1;   // continuation after ASCII
+        constexpr std::int8_t overlong_3 = 1 << 2;
+        constexpr std::int8_t too_large = 1 << 3;
+        constexpr std::int8_t surrogate = 1 << 4;
+        constexpr std::int8_t overlong_2 = 1 << 5;
+        constexpr std::int8_t too_large_1000 = 1 << 6;
+        constexpr std::int8_t overlong_4 = 1 << 6;
+        constexpr std::int8_t two_conts = static_cast<std::int8_t>(1 << 7);
+        constexpr std::int8_t carry = too_short | too_long | two_conts;
+
+#define TOYJSON_UTF8_BYTE_1_HIGH \
+    too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long, \
+    two_conts, two_conts, two_conts, two_conts, \
+    too_short | overlong_2, \
+    too_short, \
+    too_short | overlong_3 | surrogate, \
+    too_short | too_large | too_large_1000 | overlong_4
+
+#define TOYJSON_UTF8_BYTE_1_LOW \
+    carry | overlong_3 | overlong_2 | overlong_4, \
+    carry | overlong_2, \
+    carry, \
+    carry, \
+    carry | too_large, \
+    carry | too_large | too_large_1000, \
+    carry | too_large | too_large_1000, \
+    carry | too_large | too_large_1000, \
+    carry | too_large | too_large_1000, \
+    carry | too_large | too_large_1000, \
+    carry | too_large | too_large_1000, \
+    carry | too_large | too_large_1000, \
+    carry | too_large | too_large_1000, \
+    carry | too_large | too_large_1000 | surrogate, \
+    carry | too_large | too_large_1000, \
+    carry | too_large | too_large_1000
+
+#define TOYJSON_UTF8_BYTE_2_HIGH \
+    too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short, \
+    too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4, \
+    too_long | overlong_2 | two_conts | overlong_3 | too_large, \
+    too_long | overlong_2 | two_conts | surrogate | too_large, \
+    too_long | overlong_2 | two_conts | surrogate | too_large, \
+    too_short, too_short, too_short, too_short
+
+        /// @brief Per-block state: errors found so far, the previous block, and whether it ended inside a sequence.
+        struct Sse42State {
+            __m128i error;
+            __m128i prev_input;
+            __m128i prev_incomplete;
+        };
+
+        __attribute__((target("sse4.2"))) void checkBlockSse42(Sse42State& state, __m128i input) {
+            if (_mm_movemask_epi8(input) == 0) {
+                state.error = _mm_or_si128(state.error, state.prev_incomplete);
+                state.prev_input = input;
+                state.prev_incomplete = _mm_setzero_si128();
+                return;
+            }
+
+            const __m128i low_nibble = _mm_set1_epi8(0x0F);
+            const __m128i byte_1_high_table = _mm_setr_epi8(TOYJSON_UTF8_BYTE_1_HIGH);
+            const __m128i byte_1_low_table = _mm_setr_epi8(TOYJSON_UTF8_BYTE_1_LOW);
+            const __m128i byte_2_high_table = _mm_setr_epi8(TOYJSON_UTF8_BYTE_2_HIGH);
+
+            __m128i prev1 = _mm_alignr_epi8(input, state.prev_input, 15);
+            __m128i prev2 = _mm_alignr_epi8(input, state.prev_input, 14);
+            __m128i prev3 = _mm_alignr_epi8(input, state.prev_input, 13);
+
+            __m128i byte_1_high = _mm_shuffle_epi8(byte_1_high_table, _mm_and_si128(_mm_srli_epi16(prev1, 4), low_nibble));
+            __m128i byte_1_low = _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, low_nibble));
+            __m128i byte_2_high = _mm_shuffle_epi8(byte_2_high_table, _mm_and_si128(_mm_srli_epi16(input, 4), low_nibble));
+            __m128i special = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+            // Only 111_____ and 1111____ leads survive these subtractions with their top bit set.
+            __m128i is_third = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+            __m128i is_fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+            __m128i must_23 = _mm_and_si128(_mm_or_si128(is_third, is_fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+
+            state.error = _mm_or_si128(state.error, _mm_xor_si128(must_23, special));
+
+            const __m128i max_complete = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+
+            state.prev_incomplete = _mm_subs_epu8(input, max_complete);
+            state.prev_input = input;
+        }
+
+        __attribute__((target("sse4.2"))) size_t findInvalidSse42(const char* data, size_t length) {
+            Sse42State state {_mm_setzero_si128(), _mm_setzero_si128(), _mm_setzero_si128()};
+            size_t pos = 0;
+
+            for (; pos + 16 <= length; pos += 16) {
+                checkBlockSse42(state, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos)));
+
+                if (!_mm_testz_si128(state.error, state.error))
+                    return findInvalidUtf8Scalar({data, length}, backToLead(data, pos));
+            }
+
+            // Zero padding reads as ASCII, which also flags a sequence cut off by the end of input.
+            alignas(16) char tail[16] {};
+
+            if (pos < length)
+                std::memcpy(tail, data + pos, length - pos);
+            checkBlockSse42(state, _mm_load_si128(reinterpret_cast<const __m128i*>(tail)));
+            state.error = _mm_or_si128(state.error, state.prev_incomplete);
+
+            if (!_mm_testz_si128(state.error, state.error))
+                return findInvalidUtf8Scalar({data, length}, backToLead(data, pos));
+
+            return npos;
+        }
+
+        struct Avx2State {
+            __m256i error;
+            __m256i prev_input;
+            __m256i prev_incomplete;
+        };
+
+        /// @brief Shifts the bytes of the previous block into input, as _mm_alignr_epi8 does across 128-bit lanes.
+        template <int Shift>
+        __attribute__((target("avx2"))) __m256i previousBytes(__m256i input, __m256i prev_input) {
+            return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - Shift);
+        }
+
+        __attribute__((target("avx2"))) void checkBlockAvx2(Avx2State& state, __m256i input) {
+            if (_mm256_movemask_epi8(input) == 0) {
+                state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+                state.prev_input = input;
+                state.prev_incomplete = _mm256_setzero_si256();
+                return;
+            }
+
+            const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+            const __m256i byte_1_high_table = _mm256_setr_epi8(TOYJSON_UTF8_BYTE_1_HIGH, TOYJSON_UTF8_BYTE_1_HIGH);
+            const __m256i byte_1_low_table = _mm256_setr_epi8(TOYJSON_UTF8_BYTE_1_LOW, TOYJSON_UTF8_BYTE_1_LOW);
+            const __m256i byte_2_high_table = _mm256_setr_epi8(TOYJSON_UTF8_BYTE_2_HIGH, TOYJSON_UTF8_BYTE_2_HIGH);
+
+            __m256i prev1 = previousBytes<1>(input, state.prev_input);
+            __m256i prev2 = previousBytes<2>(input, state.prev_input);
+            __m256i prev3 = previousBytes<3>(input, state.prev_input);
+
+            __m256i byte_1_high = _mm256_shuffle_epi8(byte_1_high_table, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble));
+            __m256i byte_1_low = _mm256_shuffle_epi8(byte_1_low_table, _mm256_and_si256(prev1, low_nibble));
+            __m256i byte_2_high = _mm256_shuffle_epi8(byte_2_high_table, _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble));
+            __m256i special = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+            __m256i is_third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+            __m256i is_fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+            __m256i must_23 = _mm256_and_si256(_mm256_or_si256(is_third, is_fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+            state.error = _mm256_or_si256(state.error, _mm256_xor_si256(must_23, special));
+
+            const __m256i max_complete = _mm256_setr_epi8(
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+
+            state.prev_incomplete = _mm256_subs_epu8(input, max_complete);
+            state.prev_input = input;
+        }
+
+        /// @note Checks 64 bytes per step, whose ASCII-only blocks cost one load, one or and one movemask.
+        __attribute__((target("avx2"))) size_t findInvalidAvx2(const char* data, size_t length) {
+            Avx2State state {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+            size_t pos = 0;
+
+            for (; pos + 64 <= length; pos += 64) {
+                __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+                __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 32));
+
+                if (_mm256_movemask_epi8(_mm256_or_si256(first, second)) == 0) {
+                    state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+                    state.prev_input = second;
+                    state.prev_incomplete = _mm256_setzero_si256();
+                } else {
+                    checkBlockAvx2(state, first);
+                    checkBlockAvx2(state, second);
+                }
+
+                if (!_mm256_testz_si256(state.error, state.error)) {
+                    _mm256_zeroupper();
+                    return findInvalidUtf8Scalar({data, length}, backToLead(data, pos));
+                }
+            }
+
+            alignas(32) char tail[64] {};
+
+            if (pos < length)
+                std::memcpy(tail, data + pos, length - pos);
+            checkBlockAvx2(state, _mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+            checkBlockAvx2(state, _mm256_load_si256(reinterpret_cast<const __m256i*>(tail + 32)));
+            state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+
+            bool failed = !_mm256_testz_si256(state.error, state.error);
+
+            _mm256_zeroupper();
+
+            return failed ? findInvalidUtf8Scalar({data, length}, backToLead(data, pos)) : npos;
+        }
+
+#undef TOYJSON_UTF8_BYTE_1_HIGH
+#undef TOYJSON_UTF8_BYTE_1_LOW
+#undef TOYJSON_UTF8_BYTE_2_HIGH
+#endif
+
+        FindInvalidFn pickFindInvalid() {
+#ifdef TOYJSON_X86_SIMD
+            SimdLevel level = detectSimdLevel();
+
+            if (level == SimdLevel::avx2)
+                return findInvalidAvx2;
+            else if (level == SimdLevel::sse42)
+                return findInvalidSse42;
+#endif
+            return findInvalidScalar;
+        }
+    }
+
+    size_t findInvalidUtf8(std::string_view text) {
+        static const FindInvalidFn find_fn = pickFindInvalid();
+
+        return find_fn(text.data(), text.length());
+    }
+
+    size_t findInvalidUtf8Scalar(std::string_view text, size_t pos) {
+        const auto* bytes = reinterpret_cast<const std::uint8_t*>(text.data());
+        size_t length = text.length();
+
+        while (pos < length) {
+            std::uint8_t lead = bytes[pos];
+
+            if (lead < 0x80) {
+                pos++;
+                continue;
+            }
+
+            size_t count;
+            std::uint8_t low = 0x80;  // bounds of the second byte, which rule out overlongs, surrogates and values past U+10FFFF
+            std::uint8_t high = 0xBF;
+
+            if (lead >= 0xC2 && lead <= 0xDF) {
+                count = 2;
+            } else if (lead >= 0xE0 && lead <= 0xEF) {
+                count = 3;
+                low = (lead == 0xE0) ? 0xA0 : 0x80;
+                high = (lead == 0xED) ? 0x9F : 0xBF;
+            } else if (lead >= 0xF0 && lead <= 0xF4) {
+                count = 4;
+                low = (lead == 0xF0) ? 0x90 : 0x80;
+                high = (lead == 0xF4) ? 0x8F : 0xBF;
+            } else {
+                return pos;
+            }
+
+            if (pos + count > length || bytes[pos + 1] < low || bytes[pos + 1] > high)
+                return pos;
+
+            for (size_t next = pos + 2; next < pos + count; next++) {
+                if ((bytes[next] & 0xC0) != 0x80)
+                    return pos;
+            }
+
+            pos += count;
+        }
+
+        return npos;
+    }
+}